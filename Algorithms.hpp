@@ -0,0 +1,233 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include "Maze.hpp"
+#include "Utils.hpp"
+
+
+/**
+ * Ways of drawing the paths of a box before it's flipped. GROWTH is the generator's own random
+ * growth, with its loops and short dead ends. The others are the classic perfect mazes (exactly
+ * one way between any two places), drawn on the cells at every other tile from the box's top left
+ * corner, with the tiles between two cells as their passage. The tiles where neither row nor
+ * column is a cell's always stay walls, so these can't make a 2x2 square.
+ */
+namespace carve {
+    enum class Algorithm {
+        GROWTH,
+        KRUSKAL,        ///< random walls knocked down where they join two sets of a flat union-find
+        WILSON,         ///< loop-erased random walks; uniform over all spanning trees, but slowest
+        BACKTRACKER,    ///< depth first with an explicit stack; long corridors, few branches
+        GROWING_TREE    ///< grows from the newest or a random cell of the list, half and half
+    };
+
+    constexpr std::pair<Algorithm, std::string_view> NAMES[] = {
+        {Algorithm::GROWTH, "growth"}, {Algorithm::KRUSKAL, "kruskal"}, {Algorithm::WILSON, "wilson"},
+        {Algorithm::BACKTRACKER, "backtracker"}, {Algorithm::GROWING_TREE, "growing-tree"}
+    };
+
+    inline std::optional<Algorithm> algorithmFromName(std::string_view name) {
+        for(const auto& [algorithm, algorithmName] : NAMES) {
+            if(algorithmName == name) {
+                return algorithm;
+            }
+        }
+        return std::nullopt;
+    }
+
+    inline std::string_view name(Algorithm algorithm) {
+        for(const auto& [candidate, algorithmName] : NAMES) {
+            if(candidate == algorithm) {
+                return algorithmName;
+            }
+        }
+        return "";
+    }
+
+    /// The cells of a box, numbered row by row, and the tiles they and their passages are on.
+    class Cells {
+    public:
+        Cells(const Maze& maze, const BoundingBox& box)
+                : theMaze(maze)
+                , theBox(box)
+                , theColumns((box.br.x - box.tl.x) / 2 + 1)
+                , theRows((box.br.y - box.tl.y) / 2 + 1) {
+        }
+
+        std::size_t count() const {
+            return std::size_t(theColumns) * theRows;
+        }
+
+        std::size_t columns() const {
+            return theColumns;
+        }
+
+        std::size_t tile(std::size_t cell) const {
+            return theMaze.index({theBox.tl.x + 2 * static_cast<unsigned>(cell % theColumns),
+                                  theBox.tl.y + 2 * static_cast<unsigned>(cell / theColumns)});
+        }
+
+        /// The tile between two neighbouring cells.
+        std::size_t passage(std::size_t cell, std::size_t other) const {
+            return (tile(cell) + tile(other)) / 2;
+        }
+
+        /// The neighbouring cells, north, west, south and east of `cell`, that are inside the box.
+        unsigned neighbours(std::size_t cell, std::size_t (&result)[4]) const {
+            unsigned count = 0;
+            auto x = cell % theColumns;
+            auto y = cell / theColumns;
+            if(y > 0) {
+                result[count++] = cell - theColumns;
+            }
+            if(x > 0) {
+                result[count++] = cell - 1;
+            }
+            if(y + 1 < theRows) {
+                result[count++] = cell + theColumns;
+            }
+            if(x + 1 < theColumns) {
+                result[count++] = cell + 1;
+            }
+            return count;
+        }
+
+    private:
+        const Maze& theMaze;
+        BoundingBox theBox;
+        unsigned theColumns;
+        unsigned theRows;
+    };
+
+    namespace detail {
+        inline void join(Maze& maze, const Cells& cells, std::size_t cell, std::size_t other) {
+            maze[cells.tile(other)] = PATH;
+            maze[cells.passage(cell, other)] = PATH;
+        }
+
+        /// Neighbours of `cell` that no path has reached yet.
+        inline unsigned unvisited(const Maze& maze, const Cells& cells, std::size_t cell, std::size_t (&result)[4]) {
+            std::size_t all[4];
+            unsigned count = 0;
+            for(unsigned i = 0, n = cells.neighbours(cell, all); i < n; ++i) {
+                if(maze[cells.tile(all[i])] != PATH) {
+                    result[count++] = all[i];
+                }
+            }
+            return count;
+        }
+    }
+
+    /// Every cell is a path from the start; the walls are knocked down in random order.
+    template<typename Random, typename Scratch>
+    void kruskal(Maze& maze, const BoundingBox& box, Random& rand, Scratch& scratch) {
+        Cells cells(maze, box);
+        auto& parent = scratch.cells;
+        auto& walls = scratch.distances;   // cell * 2, +1 for the wall below it rather than east of it
+        parent.resize(cells.count());
+        std::iota(parent.begin(), parent.end(), 0u);
+        walls.clear();
+        for(std::size_t cell = 0; cell < cells.count(); ++cell) {
+            maze[cells.tile(cell)] = PATH;
+            std::size_t neighbours[4];
+            for(unsigned i = 0, n = cells.neighbours(cell, neighbours); i < n; ++i) {
+                if(neighbours[i] == cell + 1 || neighbours[i] == cell + cells.columns()) {
+                    walls.push_back(static_cast<std::uint32_t>(cell * 2 + (neighbours[i] != cell + 1)));
+                }
+            }
+        }
+        for(std::size_t i = walls.size(); i > 1; --i) {
+            std::swap(walls[i - 1], walls[rand.pickRandomFrom(static_cast<unsigned>(i))]);
+        }
+
+        auto find = [&](std::uint32_t cell) {
+            while(parent[cell] != cell) {
+                parent[cell] = parent[parent[cell]];   // path halving keeps the forest flat
+                cell = parent[cell];
+            }
+            return cell;
+        };
+        for(auto wall : walls) {
+            std::size_t cell = wall / 2;
+            std::size_t other = wall % 2 ? cell + cells.columns() : cell + 1;
+            auto a = find(static_cast<std::uint32_t>(cell));
+            auto b = find(static_cast<std::uint32_t>(other));
+            if(a != b) {
+                parent[a] = b;
+                maze[cells.passage(cell, other)] = PATH;
+            }
+        }
+    }
+
+    /// Random walks from each cell not yet reached until they hit the paths; only their last exits count.
+    template<typename Random, typename Scratch>
+    void wilson(Maze& maze, const BoundingBox& box, Random& rand, Scratch& scratch) {
+        Cells cells(maze, box);
+        auto& exits = scratch.cells;
+        exits.resize(cells.count());
+        auto reached = [&](std::size_t cell) { return maze[cells.tile(cell)] == PATH; };
+        maze[cells.tile(rand.pickRandomFrom(static_cast<unsigned>(cells.count())))] = PATH;
+
+        for(std::size_t start = 0; start < cells.count(); ++start) {
+            std::size_t neighbours[4];
+            for(auto cell = start; not reached(cell);) {
+                auto n = cells.neighbours(cell, neighbours);
+                auto next = neighbours[rand.pickRandomFrom(n)];
+                exits[cell] = static_cast<std::uint32_t>(next);   // a later visit overwrites the loop
+                cell = next;
+            }
+            for(auto cell = start; not reached(cell); cell = exits[cell]) {
+                maze[cells.tile(cell)] = PATH;
+                maze[cells.passage(cell, exits[cell])] = PATH;
+            }
+        }
+    }
+
+    template<typename Random, typename Scratch>
+    void backtracker(Maze& maze, const BoundingBox& box, Random& rand, Scratch& scratch) {
+        Cells cells(maze, box);
+        auto& stack = scratch.activeEndPoints;
+        stack.assign(1, rand.pickRandomFrom(static_cast<unsigned>(cells.count())));
+        maze[cells.tile(stack.back())] = PATH;
+        while(not stack.empty()) {
+            auto cell = stack.back();
+            std::size_t open[4];
+            auto n = detail::unvisited(maze, cells, cell, open);
+            if(n == 0) {
+                stack.pop_back();
+                continue;
+            }
+            auto next = open[rand.pickRandomFrom(n)];
+            detail::join(maze, cells, cell, next);
+            stack.push_back(next);
+        }
+    }
+
+    template<typename Random, typename Scratch>
+    void growingTree(Maze& maze, const BoundingBox& box, Random& rand, Scratch& scratch) {
+        Cells cells(maze, box);
+        auto& list = scratch.activeEndPoints;
+        list.assign(1, rand.pickRandomFrom(static_cast<unsigned>(cells.count())));
+        maze[cells.tile(list.back())] = PATH;
+        while(not list.empty()) {
+            auto at = rand.coinFlip() ? list.size() - 1 : rand.pickRandomFrom(static_cast<unsigned>(list.size()));
+            auto cell = list[at];
+            std::size_t open[4];
+            auto n = detail::unvisited(maze, cells, cell, open);
+            if(n == 0) {
+                list[at] = list.back();   // done with it; order only matters for the newest
+                list.pop_back();
+                continue;
+            }
+            auto next = open[rand.pickRandomFrom(n)];
+            detail::join(maze, cells, cell, next);
+            list.push_back(next);
+        }
+    }
+}
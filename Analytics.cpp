@@ -0,0 +1,114 @@
+#include "Analytics.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <ostream>
+#include <vector>
+
+#include "Maze.hpp"
+#include "Solver.hpp"
+
+
+namespace analytics {
+    namespace {
+    const char* const METRIC_NAMES[] = {"dead-ends", "junctions", "loops", "path-length", "branching"};
+
+    bool isOpen(char tile) {
+        return tile != WALL;
+    }
+    }
+
+    /**
+     * Scanning row by row, the west and north neighbours are the ones already seen: each open one
+     * is a passage, and joins the two tiles' regions in a flat union-find like connectedRegions().
+     */
+    Analysis analyze(const Maze& maze) {
+        Analysis analysis;
+        std::vector<std::size_t> parent(maze.array.size());
+        auto find = [&parent](std::size_t idx) {
+            while(parent[idx] != idx) {
+                idx = parent[idx] = parent[parent[idx]];
+            }
+            return idx;
+        };
+
+        std::size_t passages = 0;
+        std::size_t regions = 0;
+        std::size_t waysOn = 0;
+        std::size_t throughTiles = 0;
+        for(unsigned int y = 1; y + 1 < maze.height; ++y) {
+            auto rowStart = maze.index({0, y});
+            for(auto idx = rowStart + 1; idx + 1 < rowStart + maze.width; ++idx) {
+                if(not isOpen(maze[idx])) {
+                    continue;
+                }
+                ++analysis.openTiles;
+                parent[idx] = idx;
+                ++regions;
+                for(unsigned d : {dir::W, dir::N}) {
+                    auto neighbor = maze.neighbour(idx, d);
+                    if(not isOpen(maze[neighbor])) {
+                        continue;
+                    }
+                    ++passages;
+                    auto a = find(idx);
+                    auto b = find(neighbor);
+                    if(a != b) {
+                        parent[std::max(a, b)] = std::min(a, b);
+                        --regions;
+                    }
+                }
+
+                unsigned degree = 0;
+                for(unsigned d : {dir::N, dir::W, dir::S, dir::E}) {
+                    degree += isOpen(maze[maze.neighbour(idx, d)]);
+                }
+                analysis.deadEnds += degree == 1;
+                analysis.junctions += degree >= 3;
+                if(degree >= 2) {
+                    waysOn += degree - 1;
+                    ++throughTiles;
+                }
+            }
+        }
+        analysis.loops = passages + regions - analysis.openTiles;
+        analysis.branchingFactor = throughTiles ? double(waysOn) / double(throughTiles) : 0;
+
+        auto solution = solve::shortestPath(maze, solve::Algorithm::BIDIRECTIONAL);
+        analysis.pathLength = solution.solved ? solution.moves.size() : 0;
+        return analysis;
+    }
+
+    std::optional<Metric> metricFromName(const std::string& name) {
+        for(unsigned metric = 0; metric < std::size(METRIC_NAMES); ++metric) {
+            if(name == METRIC_NAMES[metric]) {
+                return static_cast<Metric>(metric);
+            }
+        }
+        return std::nullopt;
+    }
+
+    const char* name(Metric metric) {
+        return METRIC_NAMES[static_cast<unsigned>(metric)];
+    }
+
+    double score(const Analysis& analysis, Metric metric) {
+        switch(metric) {
+            case Metric::DEAD_ENDS:         return double(analysis.deadEnds);
+            case Metric::JUNCTIONS:         return double(analysis.junctions);
+            case Metric::LOOPS:             return double(analysis.loops);
+            case Metric::PATH_LENGTH:       return double(analysis.pathLength);
+            case Metric::BRANCHING_FACTOR:  return analysis.branchingFactor;
+        }
+        return 0;
+    }
+
+    void writeJson(std::ostream& os, const Analysis& analysis) {
+        os << "{\"openTiles\": " << analysis.openTiles
+           << ", \"deadEnds\": " << analysis.deadEnds
+           << ", \"junctions\": " << analysis.junctions
+           << ", \"loops\": " << analysis.loops
+           << ", \"pathLength\": " << analysis.pathLength
+           << ", \"branchingFactor\": " << analysis.branchingFactor << "}";
+    }
+}
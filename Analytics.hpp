@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <optional>
+#include <string>
+
+struct Maze;
+
+
+/**
+ * How hard a finished maze is, measured in two linear sweeps: one over the tiles for the shape
+ * of the corridors, and the B-to-E search for the path. The shape is that of the corridors, so
+ * only the 4 straight neighbours of a tile count as its ways on; B and E are open tiles.
+ */
+namespace analytics {
+    struct Analysis {
+        std::size_t openTiles = 0;
+        std::size_t deadEnds = 0;       ///< open tiles with a single way on
+        std::size_t junctions = 0;      ///< open tiles with three or four ways on
+        std::size_t loops = 0;          ///< cycle rank: passages - open tiles + separate regions
+        std::size_t pathLength = 0;     ///< steps of the shortest B-to-E path, 0 if there is none
+        double branchingFactor = 0;     ///< ways on from a tile entered, on average over the non-dead ends
+    };
+
+    Analysis analyze(const Maze& maze);
+
+    enum class Metric {
+        DEAD_ENDS,
+        JUNCTIONS,
+        LOOPS,
+        PATH_LENGTH,
+        BRANCHING_FACTOR
+    };
+
+    /// dead-ends, junctions, loops, path-length or branching.
+    std::optional<Metric> metricFromName(const std::string& name);
+    const char* name(Metric metric);
+
+    /// The figure of `analysis` that `metric` ranks mazes by, the highest first.
+    double score(const Analysis& analysis, Metric metric);
+
+    /// The figures as one JSON object.
+    void writeJson(std::ostream& os, const Analysis& analysis);
+}
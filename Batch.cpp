@@ -0,0 +1,83 @@
+#include "Batch.hpp"
+
+#include <optional>
+
+#include "MazeCreator.hpp"
+#include "RandomEngines.hpp"
+#include "Stats.hpp"
+#include "ThreadPool.hpp"
+
+
+namespace batch {
+    std::uint64_t mazeSeed(std::uint64_t seedBase, std::size_t index) {
+        return rng::streamSeed(seedBase, index);
+    }
+
+    std::vector<Maze> generate(std::size_t count, const Dimensions& dims, std::uint64_t seedBase,
+                               ThreadPool& pool, const EndpointPlacement& placement, carve::Algorithm algorithm,
+                               std::vector<stats::Generation>* generationStats) {
+        std::vector<std::optional<Maze>> slots(count);
+        std::vector<GenerationScratch> scratches(pool.size());
+        if(generationStats) {
+            generationStats->assign(count, stats::Generation{});
+        }
+        pool.parallelFor(count, [&](std::size_t index, unsigned worker) {
+            MazeCreator mc(Dimensions(dims), mazeSeed(seedBase, index), std::move(scratches[worker]));
+            mc.placeEndpoints(placement);
+            mc.useAlgorithm(algorithm);
+            mc.create();
+            if(generationStats) {
+                (*generationStats)[index] = mc.stats();
+            }
+            slots[index] = mc.takeResult();
+            scratches[worker] = mc.releaseScratch();
+        });
+
+        std::vector<Maze> mazes;
+        mazes.reserve(count);
+        for(auto& slot : slots) {
+            mazes.push_back(std::move(*slot));
+        }
+        return mazes;
+    }
+
+    Best bestOf(std::size_t candidates, const Dimensions& dims, std::uint64_t seedBase, ThreadPool& pool,
+                const EndpointPlacement& placement, carve::Algorithm algorithm, analytics::Metric metric,
+                stats::Generation* generationStats) {
+        struct Kept {
+            Best best;
+            double score;
+            stats::Generation generation;
+
+            bool beatenBy(double otherScore, std::size_t otherIndex) const {
+                return otherScore > score || (otherScore == score && otherIndex < best.index);
+            }
+        };
+        std::vector<std::optional<Kept>> kept(pool.size());
+        std::vector<GenerationScratch> scratches(pool.size());
+        pool.parallelFor(candidates, [&](std::size_t index, unsigned worker) {
+            MazeCreator mc(Dimensions(dims), mazeSeed(seedBase, index), std::move(scratches[worker]));
+            mc.placeEndpoints(placement);
+            mc.useAlgorithm(algorithm);
+            mc.create();
+            auto analysis = analytics::analyze(mc.result());
+            auto score = analytics::score(analysis, metric);
+            auto& mine = kept[worker];
+            if(not mine || mine->beatenBy(score, index)) {
+                mine = Kept{ {mc.takeResult(), index, analysis}, score, mc.stats() };
+            }
+            scratches[worker] = mc.releaseScratch();
+        });
+
+        std::optional<Kept>* winner = nullptr;
+        for(auto& candidate : kept) {
+            if(candidate && (not winner || (*winner)->beatenBy(candidate->score, candidate->best.index))) {
+                winner = &candidate;
+            }
+        }
+        if(generationStats) {
+            *generationStats = (*winner)->generation;
+        }
+        return std::move((*winner)->best);
+    }
+}
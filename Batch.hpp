@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Analytics.hpp"
+#include "Maze.hpp"
+#include "Utils.hpp"
+
+class ThreadPool;
+struct EndpointPlacement;
+namespace stats {
+    struct Generation;
+}
+namespace carve {
+    enum class Algorithm;
+}
+
+
+namespace batch {
+    /// Seed of the index-th maze of a batch. It doesn't depend on which thread builds the maze.
+    std::uint64_t mazeSeed(std::uint64_t seedBase, std::size_t index);
+
+    /**
+     * Generate `count` independent mazes on the pool; result i is always built from mazeSeed(seedBase, i).
+     * If `generationStats` is given, it receives what generating each maze took.
+     */
+    std::vector<Maze> generate(std::size_t count, const Dimensions& dims, std::uint64_t seedBase,
+                               ThreadPool& pool, const EndpointPlacement& placement, carve::Algorithm algorithm,
+                               std::vector<stats::Generation>* generationStats = nullptr);
+
+    struct Best {
+        Maze maze;
+        std::size_t index;      ///< of the candidate, built from mazeSeed(seedBase, index)
+        analytics::Analysis analysis;
+    };
+
+    /**
+     * Generate `candidates` (at least 1) mazes on the pool and keep the one scoring highest on `metric`, the
+     * first of them on a tie, so the choice doesn't depend on the pool either. Each worker only
+     * holds its best maze so far. If `generationStats` is given, it receives what generating the
+     * kept maze took.
+     */
+    Best bestOf(std::size_t candidates, const Dimensions& dims, std::uint64_t seedBase, ThreadPool& pool,
+                const EndpointPlacement& placement, carve::Algorithm algorithm, analytics::Metric metric,
+                stats::Generation* generationStats = nullptr);
+}
@@ -0,0 +1,324 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+#include "Growth.hpp"
+#include "Maze.hpp"
+#include "RandomEngines.hpp"
+#include "RandomGenerator.hpp"
+#include "Utils.hpp"
+
+
+/**
+ * The grid as one bit per tile, 64 to a word, each row starting at a fresh word: 1 is a path
+ * while drawing and an empty tile once flipped, so the flip itself costs nothing. That's an
+ * eighth of the Maze's bytes, and the whole-grid rules can be checked a word of tiles at a time.
+ */
+struct Bitboard {
+    explicit Bitboard(const Dimensions& dims)
+            : width(dims.x)
+            , height(dims.y)
+            , wordsPerRow((std::size_t(dims.x) + 63) / 64)
+            , words(wordsPerRow * dims.y, 0) {
+    }
+
+    bool test(const Coordinates& coord) const {
+        return (row(coord.y)[coord.x / 64] >> (coord.x % 64)) & 1;
+    }
+
+    void set(const Coordinates& coord) {
+        row(coord.y)[coord.x / 64] |= std::uint64_t(1) << (coord.x % 64);
+    }
+
+    void reset(const Coordinates& coord) {
+        row(coord.y)[coord.x / 64] &= ~(std::uint64_t(1) << (coord.x % 64));
+    }
+
+    std::uint64_t* row(unsigned y) {
+        return words.data() + y * wordsPerRow;
+    }
+
+    const std::uint64_t* row(unsigned y) const {
+        return words.data() + y * wordsPerRow;
+    }
+
+    /**
+     * The 3x3 tiles around `coord`, which must not be on the frame, as 9 bits: the row above in
+     * bits 0-2, its own row in 3-5 and the row below in 6-8, west to east.
+     */
+    unsigned neighbourhood(const Coordinates& coord) const {
+        return   threeBits(coord.y - 1, coord.x - 1)
+              | (threeBits(coord.y, coord.x - 1) << 3)
+              | (threeBits(coord.y + 1, coord.x - 1) << 6);
+    }
+
+    /// Tiles in the word `w` of the row whose neighbour in the given column offset (-1 or 1) is set.
+    std::uint64_t shifted(unsigned y, std::size_t w, int dx) const {
+        auto r = row(y);
+        if(dx < 0) {
+            return (r[w] << 1) | (w > 0 ? r[w - 1] >> 63 : 0);
+        }
+        return (r[w] >> 1) | (w + 1 < wordsPerRow ? r[w + 1] << 63 : 0);
+    }
+
+    /// Tiles of the word `w` that are inside the frame.
+    std::uint64_t innerMask(std::size_t w) const {
+        std::uint64_t mask = ~std::uint64_t(0);
+        std::size_t first = w * 64;
+        if(first == 0) {
+            mask &= ~std::uint64_t(1);
+        }
+        std::size_t last = width - 1;   // the frame's column; it and everything after it are out
+        if(last < first + 64) {
+            mask &= (std::uint64_t(1) << (last - first)) - 1;
+        }
+        return mask;
+    }
+
+    /// Whether there are 2x2 open tiles anywhere, checked a word of tiles at a time.
+    bool hasFreeCluster() const {
+        for(unsigned y = 1; y + 2 < height; ++y) {
+            for(std::size_t w = 0; w < wordsPerRow; ++w) {
+                auto both = row(y)[w] & row(y + 1)[w];
+                auto east = shifted(y, w, 1) & shifted(y + 1, w, 1);
+                if(both & east & innerMask(w)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    unsigned width;
+    unsigned height;
+    std::size_t wordsPerRow;
+    std::vector<std::uint64_t> words;
+
+private:
+    unsigned threeBits(unsigned y, unsigned x) const {
+        auto r = row(y);
+        unsigned shift = x % 64;
+        auto bits = r[x / 64] >> shift;
+        if(shift > 61) {
+            bits |= r[x / 64 + 1] << (64 - shift);
+        }
+        return static_cast<unsigned>(bits & 7);
+    }
+};
+
+
+namespace bitboard {
+    /// Bits of Bitboard::neighbourhood().
+    enum : unsigned { NW = 1 << 0, N = 1 << 1, NE = 1 << 2, W = 1 << 3, CENTRE = 1 << 4, E = 1 << 5,
+                      SW = 1 << 6, S = 1 << 7, SE = 1 << 8 };
+    /// The neighbourhood of a wall with nothing but open tiles around it.
+    const unsigned ISOLATED_WALL = 0x1ff & ~CENTRE;
+
+    /// What the generator wants to know of a neighbourhood, looked up rather than worked out.
+    struct Rules {
+        bool wouldNotCompleteSquare;
+        std::uint8_t surroundingPaths;   ///< of the 4 straight neighbours
+    };
+
+    constexpr std::array<Rules, 512> makeRules() {
+        std::array<Rules, 512> rules{};
+        for(unsigned p = 0; p < 512; ++p) {
+            auto all = [p](unsigned mask) { return (p & mask) == mask; };
+            rules[p].wouldNotCompleteSquare =    not all(N | W | NW) && not all(N | E | NE)
+                                              && not all(S | W | SW) && not all(S | E | SE);
+            rules[p].surroundingPaths = static_cast<std::uint8_t>(
+                bool(p & N) + bool(p & W) + bool(p & E) + bool(p & S));
+        }
+        return rules;
+    }
+
+    constexpr std::array<Rules, 512> RULES = makeRules();
+
+    /// Index of the lowest set bit of a non-zero word: a single instruction where the compiler has one.
+    inline unsigned lowestBit(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctzll(word));
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanForward64(&index, word);
+        return static_cast<unsigned>(index);
+#else
+        unsigned index = 0;
+        for(; not (word & 1); word >>= 1) {
+            ++index;
+        }
+        return index;
+#endif
+    }
+
+    /**
+     * The grid policy of the growth (see Growth.hpp) on a Bitboard: the rules are looked up from a
+     * tile's neighbourhood in one go, and the gaps are found a word of tiles at a time. B and E are
+     * kept aside, since a bit only tells open tiles from walls.
+     */
+    class Grid {
+    public:
+        using Tile = Coordinates;
+
+        Grid(Bitboard& board, const BoundingBox& inner)
+                : theBoard(board)
+                , theInnerBb(inner) {
+        }
+
+        Tile tile(const Coordinates& coord) const {
+            return coord;
+        }
+
+        Tile neighbour(const Coordinates& coord, unsigned direction) const {
+            return coord.neighbour(direction);
+        }
+
+        bool isViable(const Coordinates& coord) const {
+            if(not isInside(coord)) {
+                return false;
+            }
+            auto pattern = theBoard.neighbourhood(coord);
+            return not (pattern & CENTRE) && RULES[pattern].wouldNotCompleteSquare;
+        }
+
+        unsigned surroundingPaths(const Coordinates& coord) const {
+            return RULES[theBoard.neighbourhood(coord)].surroundingPaths;
+        }
+
+        void drawPath(const Coordinates& coord) {
+            theBoard.set(coord);
+        }
+
+        bool isIsolatedWall(const Coordinates& coord) const {
+            return theBoard.neighbourhood(coord) == ISOLATED_WALL;
+        }
+
+        /// The sweep takes a word of tiles at a time, in the same order as the Maze's.
+        template<typename List>
+        void collectGaps(const BoundingBox& box, List& gaps) const {
+            for(unsigned y = box.tl.y; y <= box.br.y; ++y) {
+                const auto* above = theBoard.row(y - 1);
+                const auto* own = theBoard.row(y);
+                const auto* below = theBoard.row(y + 1);
+                for(std::size_t w = 0; w < theBoard.wordsPerRow; ++w) {
+                    auto isolated = ~own[w] & above[w] & below[w] & theBoard.innerMask(w) & columns(box, w);
+                    for(unsigned r : {y - 1, y, y + 1}) {
+                        isolated &= theBoard.shifted(r, w, -1) & theBoard.shifted(r, w, 1);
+                    }
+                    while(isolated) {
+                        gaps.push_back({static_cast<unsigned>(w * 64 + lowestBit(isolated)), y});
+                        isolated &= isolated - 1;
+                    }
+                }
+            }
+        }
+
+        bool closeWall(const Coordinates& coord) {
+            bool added = theBoard.test(coord);
+            theBoard.reset(coord);
+            return added;
+        }
+
+        bool isEmpty(const Coordinates& coord) const {
+            return theBoard.test(coord) && not (coord.x == begin.x && coord.y == begin.y);
+        }
+
+        void drop(const Coordinates& coord, char type) {
+            (type == BEGIN ? begin : end) = coord;
+        }
+
+        Coordinates begin{0, 0};   // on the frame until dropped
+        Coordinates end{0, 0};
+
+    private:
+        bool isInside(const Coordinates& coord) const {
+            return    coord.x >= theInnerBb.tl.x && coord.x <= theInnerBb.br.x
+                   && coord.y >= theInnerBb.tl.y && coord.y <= theInnerBb.br.y;
+        }
+
+        /// The tiles of the word `w` that are in the box's columns.
+        static std::uint64_t columns(const BoundingBox& box, std::size_t w) {
+            std::uint64_t mask = ~std::uint64_t(0);
+            std::size_t first = w * 64;
+            if(box.tl.x > first) {
+                mask = box.tl.x - first < 64 ? mask << (box.tl.x - first) : 0;
+            }
+            if(box.br.x < first + 63) {
+                mask &= box.br.x < first ? 0 : ~std::uint64_t(0) >> (63 - (box.br.x - first));
+            }
+            return mask;
+        }
+
+        Bitboard& theBoard;
+        BoundingBox theInnerBb;
+    };
+}
+
+
+/**
+ * The generator of BasicMazeCreator::create() on a Bitboard: the same growth, gap closing and
+ * endpoints (Growth.hpp) on bitboard::Grid, so the same seed and dimensions give exactly the same
+ * maze, with B and E dropped at random. The Maze is only made for the result. There's no tiling,
+ * endpoint placement or stats here.
+ */
+template<typename Engine = rng::DefaultEngine>
+class BasicBitboardCreator {
+public:
+    using Random = BasicRandomCoordinateGenerator<Engine>;
+
+    BasicBitboardCreator(const Dimensions& dims, std::uint64_t seed = Random::entropySeed())
+            : theDims(dims)
+            , theInnerBb{ {1,1}, {dims.x - 2, dims.y - 2} }
+            , theBoard(dims)
+            , theGrid(theBoard, theInnerBb)
+            , theRand(theInnerBb, seed) {
+    }
+
+    void create() {
+        growth::grow(theGrid, theRand.getRandomCoordinate(), theRand, theActive, theWaiting, theNext);
+        growth::closeGaps(theGrid, theInnerBb, theGaps, theRand);   // the board already reads as flipped
+        growth::dropRandomEndpoints(theGrid, theRand);
+    }
+
+    const Bitboard& board() const {
+        return theBoard;
+    }
+
+    /// The maze as text tiles, B and E included.
+    Maze result() const {
+        Maze maze(theDims);
+        for(unsigned y = 0; y < theDims.y; ++y) {
+            auto bits = theBoard.row(y);
+            auto tiles = maze.row(y);
+            for(unsigned x = 0; x < theDims.x; ++x) {
+                tiles[x] = (bits[x / 64] >> (x % 64)) & 1 ? EMPTY : WALL;
+            }
+        }
+        maze[theGrid.begin] = BEGIN;
+        maze[theGrid.end] = END;
+        return maze;
+    }
+
+    std::uint64_t seed() const {
+        return theRand.getSeed();
+    }
+
+private:
+    Dimensions theDims;
+    BoundingBox theInnerBb;
+    Bitboard theBoard;
+    bitboard::Grid theGrid;
+    Random theRand;
+    std::vector<Coordinates> theActive;
+    std::vector<Coordinates> theWaiting;
+    std::vector<Coordinates> theNext;
+    std::vector<Coordinates> theGaps;
+};
+
+using BitboardCreator = BasicBitboardCreator<>;
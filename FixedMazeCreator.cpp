@@ -0,0 +1,32 @@
+#include "FixedMazeCreator.hpp"
+
+
+namespace fixed {
+    namespace {
+    template<unsigned W, unsigned H>
+    bool appendIf(const Dimensions& dims, std::uint64_t seed, std::string& out) {
+        if(dims.x != W || dims.y != H) {
+            return false;
+        }
+        FixedMazeCreator<W, H> creator(seed);
+        creator.create();
+        out.append(creator.text());
+        return true;
+    }
+    }
+
+    bool isHotSize(const Dimensions& dims) {
+        for(const auto& hot : HOT_SIZES) {
+            if(dims.x == hot.x && dims.y == hot.y) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool appendText(const Dimensions& dims, std::uint64_t seed, std::string& out) {
+        return    appendIf<15, 15>(dims, seed, out)
+               || appendIf<21, 21>(dims, seed, out)
+               || appendIf<31, 31>(dims, seed, out);
+    }
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "Growth.hpp"
+#include "Maze.hpp"
+#include "RandomEngines.hpp"
+#include "RandomGenerator.hpp"
+#include "Utils.hpp"
+
+
+/**
+ * BasicMazeCreator::create() for a size known at compile time: the same growth, gap closing and
+ * endpoints (Growth.hpp), with the grid and every list of tiles in arrays inside the object and the
+ * neighbour offsets and the frame as constants. Nothing is allocated, so a creator on the stack
+ * makes a maze without touching the heap. The same seed gives exactly the same maze as the
+ * dynamic creator, B and E dropped at random.
+ */
+template<unsigned W, unsigned H, typename Engine = rng::DefaultEngine>
+class FixedMazeCreator {
+    static_assert(W >= 4 && H >= 4, "the maze needs room for B and E inside its frame");
+    static_assert(std::size_t(W + 1) * H <= 65536, "tiles are indexed with 16 bits");
+
+public:
+    using Random = BasicRandomCoordinateGenerator<Engine>;
+
+    static constexpr std::size_t STRIDE = std::size_t(W) + 1;
+    static constexpr std::size_t SIZE = STRIDE * H;
+
+    explicit FixedMazeCreator(std::uint64_t seed = Random::entropySeed())
+            : theRand(INNER_BB, seed) {
+    }
+
+    void create() {
+        theStorage.tiles = BLANK;
+        growth::TextGrid<Storage> grid(theStorage);
+        growth::grow(grid, Storage::index(theRand.getRandomCoordinate()), theRand,
+                     theFrontiers[0], theFrontiers[1], theFrontiers[2]);
+        flip();
+        growth::closeGaps(grid, INNER_BB, theGaps, theRand);
+        growth::dropRandomEndpoints(grid, theRand);
+    }
+
+    /// Another maze from `seed`.
+    void regenerate(std::uint64_t seed) {
+        theRand = Random(INNER_BB, seed);
+        create();
+    }
+
+    /// The printable maze, laid out like Maze::text().
+    std::string_view text() const {
+        return {theStorage.tiles.data(), SIZE};
+    }
+
+    /// A copy as a dynamic Maze, for everything that takes one.
+    Maze result() const {
+        Maze maze({W, H});
+        std::copy(theStorage.tiles.begin(), theStorage.tiles.end(), maze.array.begin());
+        return maze;
+    }
+
+    std::uint64_t seed() const {
+        return theRand.getSeed();
+    }
+
+private:
+    using Index = std::uint16_t;
+
+    static constexpr BoundingBox INNER_BB{ {1, 1}, {W - 2, H - 2} };
+    static constexpr std::size_t INNER_AREA = std::size_t(W - 2) * (H - 2);
+
+    /// Every tile turns into a path at most once, and is collected as a gap at most once.
+    template<std::size_t CAPACITY>
+    struct TileList {
+        std::array<Index, CAPACITY> items;
+        std::size_t count = 0;
+
+        void push_back(std::size_t idx) { items[count++] = static_cast<Index>(idx); }
+        void clear() { count = 0; }
+        bool empty() const { return count == 0; }
+        std::size_t size() const { return count; }
+        const Index* begin() const { return items.data(); }
+        const Index* end() const { return items.data() + count; }
+    };
+    using Frontier = TileList<INNER_AREA>;
+
+    static constexpr std::array<std::ptrdiff_t, dir::COUNT> makeOffsets() {
+        std::array<std::ptrdiff_t, dir::COUNT> offsets{};
+        for(unsigned d = 0; d < dir::COUNT; ++d) {
+            offsets[d] = std::ptrdiff_t(NEIGHBOURS[d].dy) * std::ptrdiff_t(STRIDE) + NEIGHBOURS[d].dx;
+        }
+        return offsets;
+    }
+
+    /// The framed, empty grid every maze starts from.
+    static constexpr std::array<char, SIZE> makeBlank() {
+        std::array<char, SIZE> grid{};
+        for(std::size_t y = 0; y < H; ++y) {
+            for(std::size_t x = 0; x < W; ++x) {
+                grid[y * STRIDE + x] = (x == 0 || y == 0 || x == W - 1 || y == H - 1) ? WALL : EMPTY;
+            }
+            grid[y * STRIDE + W] = '\n';
+        }
+        return grid;
+    }
+
+    static constexpr std::array<std::ptrdiff_t, dir::COUNT> OFFSETS = makeOffsets();
+    static constexpr std::array<char, SIZE> BLANK = makeBlank();
+
+    /// The tiles, addressed like a Maze's with the layout as constants (see growth::TextGrid).
+    struct Storage {
+        std::array<char, SIZE> tiles;
+
+        static std::size_t index(const Coordinates& coord) {
+            return coord.y * STRIDE + coord.x;
+        }
+
+        static std::size_t neighbour(std::size_t idx, unsigned direction) {
+            return idx + OFFSETS[direction];
+        }
+
+        char& operator[](std::size_t idx) { return tiles[idx]; }
+        const char& operator[](std::size_t idx) const { return tiles[idx]; }
+    };
+
+    void flip() {
+        for(std::size_t y = 1; y < H - 1; ++y) {
+            for(std::size_t x = 1; x < W - 1; ++x) {
+                auto& tile = theStorage.tiles[y * STRIDE + x];
+                tile = tile == PATH ? EMPTY : WALL;
+            }
+        }
+    }
+
+    Storage theStorage;
+    Random theRand;
+    std::array<Frontier, 3> theFrontiers;
+    TileList<INNER_AREA> theGaps;
+};
+
+
+namespace fixed {
+    /// The sizes most requests ask for, which get a FixedMazeCreator of their own.
+    constexpr Dimensions HOT_SIZES[] = { {15, 15}, {21, 21}, {31, 31} };
+
+    bool isHotSize(const Dimensions& dims);
+
+    /// Append the text of the maze of a hot size made from `seed` to `out`; false for other sizes.
+    bool appendText(const Dimensions& dims, std::uint64_t seed, std::string& out);
+}
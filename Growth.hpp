@@ -0,0 +1,261 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+#include "Maze.hpp"
+#include "Stats.hpp"
+
+
+/**
+ * The generator's own growth, its gap closing and its random endpoints, written once for every
+ * way of storing the grid. The storage is a grid policy, which knows how its tiles are addressed
+ * and answers the rules for them:
+ *
+ *   Tile                           how a tile is addressed: an index, or its coordinates
+ *   tile(coord)                    the tile at the coordinates
+ *   neighbour(tile, direction)     see dir::
+ *   isViable(tile)                 an empty tile that can become a path without completing a square
+ *   surroundingPaths(tile)         paths among the 4 straight neighbours
+ *   drawPath(tile)
+ *   collectGaps(box, list)         append the isolated walls of the flipped box, row by row
+ *   isIsolatedWall(tile)
+ *   closeWall(tile)                make it a wall; whether it wasn't one already
+ *   isEmpty(tile), drop(tile, type)
+ *
+ * TextGrid is the policy for tile chars, in a Maze or an array sized at compile time; Bitboard.hpp
+ * has the one for bits. The worklists are any containers of tiles with push_back(), clear(),
+ * empty(), size() and iteration, so they can be vectors or arrays too. The same seed makes the
+ * same decisions on every storage.
+ */
+namespace growth {
+    /// Tile chars behind `Tiles`, which has operator[], index() and neighbour() like a Maze.
+    template<typename Tiles>
+    class TextGrid {
+    public:
+        using Tile = std::size_t;
+
+        explicit TextGrid(Tiles& tiles)
+                : theTiles(tiles) {
+        }
+
+        Tile tile(const Coordinates& coord) const {
+            return theTiles.index(coord);
+        }
+
+        Tile neighbour(Tile idx, unsigned direction) const {
+            return theTiles.neighbour(idx, direction);
+        }
+
+        /// The frame is walled before drawing, so an EMPTY tile is always inside the inner box.
+        bool isViable(Tile idx) const {
+            return    theTiles[idx] == EMPTY
+                   && wouldNotCompleteSquare(idx);
+        }
+
+        unsigned surroundingPaths(Tile idx) const {
+            return   unsigned(isPath(idx, dir::N))
+                   + unsigned(isPath(idx, dir::W))
+                   + unsigned(isPath(idx, dir::E))
+                   + unsigned(isPath(idx, dir::S));
+        }
+
+        void drawPath(Tile idx) {
+            theTiles[idx] = PATH;
+        }
+
+        /// A wall piece with nothing but empty tiles around it.
+        bool isIsolatedWall(Tile idx) const {
+            if(theTiles[idx] != WALL) {
+                return false;
+            }
+            for(unsigned d = 0; d < dir::COUNT; ++d) {
+                if(theTiles[neighbour(idx, d)] != EMPTY) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template<typename List>
+        void collectGaps(const BoundingBox& box, List& gaps) const {
+            for(unsigned y = box.tl.y; y <= box.br.y; ++y) {
+                for(unsigned x = box.tl.x; x <= box.br.x; ++x) {
+                    auto idx = tile({x, y});
+                    if(isIsolatedWall(idx)) {
+                        gaps.push_back(idx);
+                    }
+                }
+            }
+        }
+
+        bool closeWall(Tile idx) {
+            bool added = theTiles[idx] != WALL;
+            theTiles[idx] = WALL;
+            return added;
+        }
+
+        bool isEmpty(Tile idx) const {
+            return theTiles[idx] == EMPTY;
+        }
+
+        void drop(Tile idx, char type) {
+            theTiles[idx] = type;
+        }
+
+    private:
+        bool isPath(Tile idx, unsigned direction) const {
+            return theTiles[neighbour(idx, direction)] == PATH;
+        }
+
+        /** A square cluster can only be completed if one corner is full.
+         *   xx <- yes   no -> x x      x: taken  o: candidate
+         *   xo                xox
+         *                     x x
+         */
+        bool wouldNotCompleteSquare(Tile idx) const {
+            return     not (isPath(idx, dir::N) && isPath(idx, dir::W) && isPath(idx, dir::NW))
+                    && not (isPath(idx, dir::N) && isPath(idx, dir::E) && isPath(idx, dir::NE))
+                    && not (isPath(idx, dir::S) && isPath(idx, dir::W) && isPath(idx, dir::SW))
+                    && not (isPath(idx, dir::S) && isPath(idx, dir::E) && isPath(idx, dir::SE));
+        }
+
+        Tiles& theTiles;
+    };
+
+    /**
+     * Draw where the free tiles will be, from `start` on. This is much easier than trying to guess
+     * walls, since most paths will be one tile wide and will either stop, continue, turn, or branch
+     * into 2 or 3. This will ensure that all paths are connected. Only tiles enclosed by walls
+     * around `start` are touched. The three lists are the worklists; `stats` may be null.
+     */
+    template<typename Grid, typename List, typename Random>
+    void grow(Grid& grid, typename Grid::Tile start, Random& rand,
+              List& activeList, List& waitingList, List& nextList, stats::Generation* stats = nullptr) {
+        grid.drawPath(start);
+
+        // Endpoints that already have 2 surrounding paths may only grow when the normal rules
+        // do not allow us to complete the maze (emergency protocol), so instead of rescanning
+        // them every round, they wait in their own list until nothing else is active.
+        List* active = &activeList;
+        List* waiting = &waitingList;
+        List* next = &nextList;
+        active->clear();
+        active->push_back(start);
+        waiting->clear();
+        next->clear();
+        auto addPath = [&](typename Grid::Tile tile) {
+            grid.drawPath(tile);
+            next->push_back(tile);
+        };
+        while(not active->empty() || not waiting->empty()) {
+            bool emergencyProtocol = active->empty();
+            if(emergencyProtocol) {
+                std::swap(active, waiting);
+            }
+            if constexpr(stats::ENABLED) {
+                if(stats) {
+                    ++stats->drawRounds;
+                    stats->peakFrontier = std::max(stats->peakFrontier, active->size() + waiting->size());
+                }
+            }
+            for(typename Grid::Tile tile : *active) {
+                auto n = grid.neighbour(tile, dir::N);
+                auto w = grid.neighbour(tile, dir::W);
+                auto s = grid.neighbour(tile, dir::S);
+                auto e = grid.neighbour(tile, dir::E);
+                bool nViable = grid.isViable(n);
+                bool wViable = grid.isViable(w);
+                bool sViable = grid.isViable(s);
+                bool eViable = grid.isViable(e);
+                auto surroundingPaths = grid.surroundingPaths(tile);
+                if(   (not nViable && not wViable && not sViable && not eViable)
+                   || surroundingPaths == 3) {
+                    continue;
+                }
+                if(surroundingPaths == 2 && not emergencyProtocol) {
+                    waiting->push_back(tile);
+                    continue;
+                }
+                next->push_back(tile);
+
+                // This should probably be in random order instead
+                if(nViable && rand.coinFlip()) {
+                    addPath(n);
+                    // we have to re-evaluate downstream every time there's an insert
+                    wViable = grid.isViable(w);
+                    sViable = grid.isViable(s);
+                    eViable = grid.isViable(e);
+                }
+                if(wViable && rand.coinFlip()) {
+                    addPath(w);
+                    sViable = grid.isViable(s);
+                    eViable = grid.isViable(e);
+                }
+                if(sViable && rand.coinFlip()) {
+                    addPath(s);
+                    eViable = grid.isViable(e);
+                }
+                if(eViable && rand.coinFlip()) {
+                    addPath(e);
+                }
+            }
+            // Every tile turns into a path exactly once, so the batch never holds duplicates.
+            active->clear();
+            for(typename Grid::Tile tile : *next) {
+                (grid.surroundingPaths(tile) == 2 ? waiting : active)->push_back(tile);
+            }
+            next->clear();
+        }
+    }
+
+    /**
+     * Certain wall pieces of the flipped box would just be dangling without connection; attach
+     * each to a random neighbour. The box is only swept once to collect the gaps, with no second
+     * sweep to confirm the fixes: closing a tile can't isolate another wall, since every wall
+     * next to it now has a wall next to it too, so it can only attach gaps collected later,
+     * which are skipped.
+     */
+    template<typename Grid, typename List, typename Random>
+    void closeGaps(Grid& grid, const BoundingBox& box, List& gaps, Random& rand,
+                   stats::Generation* stats = nullptr) {
+        gaps.clear();
+        grid.collectGaps(box, gaps);
+        for(typename Grid::Tile gap : gaps) {
+            if(not grid.isIsolatedWall(gap)) {   // an earlier fix already attached it
+                continue;
+            }
+            // close a random direction
+            bool added = grid.closeWall(grid.neighbour(gap, rand.pickRandomFrom(dir::COUNT)));
+            if constexpr(stats::ENABLED) {
+                if(stats) {
+                    stats->wallsAdded += added;
+                }
+            }
+        }
+        if constexpr(stats::ENABLED) {
+            if(stats) {
+                stats->gapsChecked += gaps.size();
+            }
+        }
+    }
+
+    template<typename Grid, typename Random>
+    typename Grid::Tile randomEmptyTile(const Grid& grid, Random& rand) {
+        typename Grid::Tile tile;
+        do {
+            tile = grid.tile(rand.getRandomCoordinate());
+        }
+        while(not grid.isEmpty(tile));
+        return tile;
+    }
+
+    /// B, then E, each on a random empty tile.
+    template<typename Grid, typename Random>
+    void dropRandomEndpoints(Grid& grid, Random& rand) {
+        for(auto type : {BEGIN, END}) {
+            grid.drop(randomEmptyTile(grid, rand), type);
+        }
+    }
+}
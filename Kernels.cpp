@@ -0,0 +1,99 @@
+#include "Kernels.hpp"
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+#include "Maze.hpp"
+
+
+namespace kernels {
+    namespace {
+#if defined(__AVX2__)
+    #define MAZY_SIMD
+    using Vec = __m256i;
+    const std::size_t LANES = 32;
+    const char* const NAME = "avx2";
+
+    Vec load(const char* p) { return _mm256_loadu_si256(reinterpret_cast<const Vec*>(p)); }
+    void store(char* p, Vec v) { _mm256_storeu_si256(reinterpret_cast<Vec*>(p), v); }
+    Vec splat(char c) { return _mm256_set1_epi8(c); }
+    Vec equal(Vec a, Vec b) { return _mm256_cmpeq_epi8(a, b); }
+    Vec both(Vec a, Vec b) { return _mm256_and_si256(a, b); }
+    Vec either(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+    Vec onlySecond(Vec a, Vec b) { return _mm256_andnot_si256(a, b); }   // ~a & b
+    bool any(Vec v) { return _mm256_movemask_epi8(v) != 0; }
+#elif defined(__SSE2__) || defined(_M_X64)
+    #define MAZY_SIMD
+    using Vec = __m128i;
+    const std::size_t LANES = 16;
+    const char* const NAME = "sse2";
+
+    Vec load(const char* p) { return _mm_loadu_si128(reinterpret_cast<const Vec*>(p)); }
+    void store(char* p, Vec v) { _mm_storeu_si128(reinterpret_cast<Vec*>(p), v); }
+    Vec splat(char c) { return _mm_set1_epi8(c); }
+    Vec equal(Vec a, Vec b) { return _mm_cmpeq_epi8(a, b); }
+    Vec both(Vec a, Vec b) { return _mm_and_si128(a, b); }
+    Vec either(Vec a, Vec b) { return _mm_or_si128(a, b); }
+    Vec onlySecond(Vec a, Vec b) { return _mm_andnot_si128(a, b); }   // ~a & b
+    bool any(Vec v) { return _mm_movemask_epi8(v) != 0; }
+#else
+    const std::size_t LANES = 0;
+    const char* const NAME = "scalar";
+#endif
+    }
+
+    const char* instructionSet() {
+        return NAME;
+    }
+
+    bool hasFreeCluster(const char* top, const char* bottom, std::size_t length) {
+        std::size_t x = 0;
+#ifdef MAZY_SIMD
+        // "is EMPTY" masks of both rows, ANDed with themselves shifted by one tile
+        const Vec empty = splat(EMPTY);
+        for(; x + LANES < length; x += LANES) {
+            Vec square = both(both(equal(load(top + x), empty), equal(load(top + x + 1), empty)),
+                              both(equal(load(bottom + x), empty), equal(load(bottom + x + 1), empty)));
+            if(any(square)) {
+                return true;
+            }
+        }
+#endif
+        for(; x + 1 < length; ++x) {
+            if(top[x] == EMPTY    && top[x+1] == EMPTY &&
+               bottom[x] == EMPTY && bottom[x+1] == EMPTY) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool flipRow(char* row, std::size_t length) {
+        bool allExpected = true;
+        std::size_t x = 0;
+#ifdef MAZY_SIMD
+        const Vec path = splat(PATH);
+        const Vec empty = splat(EMPTY);
+        const Vec wall = splat(WALL);
+        for(; x + LANES <= length; x += LANES) {
+            Vec tiles = load(row + x);
+            Vec isPath = equal(tiles, path);
+            Vec isEmpty = equal(tiles, empty);
+            Vec isOther = onlySecond(either(isPath, isEmpty), splat(char(-1)));
+            allExpected &= not any(isOther);
+            store(row + x, either(either(both(isPath, empty), both(isEmpty, wall)), both(isOther, tiles)));
+        }
+#endif
+        for(; x < length; ++x) {
+            if(row[x] == PATH) {
+                row[x] = EMPTY;
+            } else if(row[x] == EMPTY) {
+                row[x] = WALL;
+            } else {
+                allExpected = false;
+            }
+        }
+        return allExpected;
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+
+
+/**
+ * Full-row tile kernels. They process whole row segments at a time with AVX2 or SSE2, whichever
+ * the build targets (e.g. -mavx2 or -march=native), and fall back to plain loops otherwise.
+ */
+namespace kernels {
+    /// Name of the instruction set the kernels were built for.
+    const char* instructionSet();
+
+    /// Whether any x in [0, length - 1) has EMPTY at x and x+1 in both rows, i.e. a 2x2 open square.
+    bool hasFreeCluster(const char* top, const char* bottom, std::size_t length);
+
+    /**
+     * Turn PATH into EMPTY and EMPTY into WALL in the first `length` tiles of `row`.
+     * Other tiles are left alone; returns false if there were any.
+     */
+    bool flipRow(char* row, std::size_t length);
+}
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <iostream>
+#include <string_view>
 #include <vector>
 
 #include "Utils.hpp"
@@ -13,20 +17,86 @@ const char PATH = 'o';
 const char EMPTY = ' ';
 
 
+/**
+ * The tiles are stored in one contiguous row-major buffer, so that the full-grid sweeps
+ * (border fill, flip, gap closing, validation) walk memory linearly instead of chasing
+ * a separate allocation per row.
+ * Every row is followed by its line break, so the buffer is the printable maze as it is.
+ */
 struct Maze {
-    explicit Maze(const Dimensions& dims)
-        : array{dims.y, decltype(array)::value_type(dims.x, EMPTY)} {
+    explicit Maze(const Dimensions& dims) {
+        reset(dims);
+    }
+
+    /// Start over as an empty maze of the given size, in the same buffer if it's big enough.
+    void reset(const Dimensions& dims) {
+        width = dims.x;
+        height = dims.y;
+        stride = std::size_t(dims.x) + 1;
+        array.assign(stride * dims.y, EMPTY);
+        for(unsigned int y = 0; y < height; ++y) {
+            row(y)[width] = '\n';
+        }
+        for(unsigned d = 0; d < dir::COUNT; ++d) {
+            neighbourOffsets[d] = std::ptrdiff_t(NEIGHBOURS[d].dy) * std::ptrdiff_t(stride) + NEIGHBOURS[d].dx;
+        }
+    }
+
+    /// Set every tile, keeping the line breaks.
+    void fill(char tile) {
+        for(unsigned int y = 0; y < height; ++y) {
+            std::fill_n(row(y), width, tile);
+            row(y)[width] = '\n';
+        }
+    }
+
+    std::size_t index(const Coordinates& coord) const {
+        return std::size_t(coord.y) * stride + coord.x;
+    }
+
+    Coordinates coordinates(std::size_t idx) const {
+        return {static_cast<unsigned int>(idx % stride), static_cast<unsigned int>(idx / stride)};
+    }
+
+    /// Linear index of the neighbour of `idx` in the given direction (see dir::).
+    std::size_t neighbour(std::size_t idx, unsigned direction) const {
+        return idx + neighbourOffsets[direction];
+    }
+
+    char& operator[](std::size_t idx) {
+        return array[idx];
+    }
+
+    const char& operator[](std::size_t idx) const {
+        return array[idx];
     }
 
     char& operator[](const Coordinates& coord) {
-        return array[coord.y][coord.x];
+        return array[index(coord)];
     }
 
     const char& operator[](const Coordinates& coord) const {
-        return array[coord.y][coord.x];
+        return array[index(coord)];
+    }
+
+    char* row(unsigned int y) {
+        return array.data() + std::size_t(y) * stride;
+    }
+
+    const char* row(unsigned int y) const {
+        return array.data() + std::size_t(y) * stride;
+    }
+
+    /// The maze exactly as it is printed, ready to be written in one go.
+    std::string_view text() const {
+        return {array.data(), array.size()};
     }
 
-    std::vector<std::vector<char>> array;
+    unsigned int width;
+    unsigned int height;
+    std::size_t stride;                 ///< distance between rows: the width plus the line break
+    std::vector<char> array;
+    std::array<std::ptrdiff_t, dir::COUNT> neighbourOffsets;
 };
 
 
@@ -0,0 +1,245 @@
+#include "MazeIO.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAZY_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Maze.hpp"
+#include "Utils.hpp"
+
+
+namespace io {
+    namespace {
+    using Filler = std::function<void(char*)>;
+
+    validate::Result writeWithStream(std::size_t size, const Filler& fill, const std::string& path) {
+        std::vector<char> buffer(size);
+        fill(buffer.data());
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if(not file) {
+            utils::errorMsg("Could not write ") << path << std::endl;
+            return validate::Result::NOK;
+        }
+        return validate::Result::OK;
+    }
+
+    /// Create `path` with `size` bytes and let `fill` write them straight into the mapped file.
+    validate::Result writeMapped(std::size_t size, const Filler& fill, const std::string& path) {
+#ifdef MAZY_HAS_MMAP
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if(fd < 0) {
+            utils::errorMsg("Could not open ") << path << std::endl;
+            return validate::Result::NOK;
+        }
+        if(size == 0 || ::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            ::close(fd);
+            return writeWithStream(size, fill, path);
+        }
+        void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if(mapping == MAP_FAILED) {
+            return writeWithStream(size, fill, path);
+        }
+        fill(static_cast<char*>(mapping));
+        ::munmap(mapping, size);
+        return validate::Result::OK;
+#else
+        return writeWithStream(size, fill, path);
+#endif
+    }
+
+    template<typename T>
+    char* put(char* out, T value) {
+        for(std::size_t i = 0; i < sizeof(T); ++i) {
+            *out++ = static_cast<char>((value >> (8 * i)) & 0xff);
+        }
+        return out;
+    }
+
+    template<typename T>
+    T get(const unsigned char* in) {
+        T value = 0;
+        for(std::size_t i = 0; i < sizeof(T); ++i) {
+            value |= T(in[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    Coordinates find(const Maze& maze, char tile) {
+        auto text = maze.text();
+        auto pos = text.find(tile);
+        if(pos == std::string_view::npos) {
+            return {NO_TILE, NO_TILE};
+        }
+        return maze.coordinates(pos);
+    }
+    }
+
+    validate::Result writeText(const Maze& maze, const std::string& path) {
+        auto text = maze.text();
+        return writeMapped(text.size(), [&](char* out) { std::memcpy(out, text.data(), text.size()); }, path);
+    }
+
+    std::size_t binarySize(const Maze& maze) {
+        return BINARY_HEADER_SIZE + (std::size_t(maze.width) * maze.height + 7) / 8;
+    }
+
+    void encodeBinary(const Maze& maze, std::uint64_t seed, char* out) {
+        auto begin = find(maze, BEGIN);
+        auto end = find(maze, END);
+        std::memcpy(out, "MAZY", 4);
+        out = put(out + 4, BINARY_VERSION);
+        out = put(out, std::uint16_t(BINARY_HEADER_SIZE));
+        out = put(out, maze.width);
+        out = put(out, maze.height);
+        out = put(out, seed);
+        for(auto value : {begin.x, begin.y, end.x, end.y}) {
+            out = put(out, value);
+        }
+
+        unsigned char byte = 0;
+        std::size_t bit = 0;
+        for(unsigned int y = 0; y < maze.height; ++y) {
+            const char* row = maze.row(y);
+            for(unsigned int x = 0; x < maze.width; ++x) {
+                byte |= (row[x] == WALL) << (bit % 8);
+                if(++bit % 8 == 0) {
+                    *out++ = static_cast<char>(byte);
+                    byte = 0;
+                }
+            }
+        }
+        if(bit % 8) {
+            *out = static_cast<char>(byte);
+        }
+    }
+
+    validate::Result writeBinary(const Maze& maze, std::uint64_t seed, const std::string& path) {
+        return writeMapped(binarySize(maze), [&](char* out) { encodeBinary(maze, seed, out); }, path);
+    }
+
+    MappedMaze::MappedMaze(MappedMaze&& other) {
+        *this = std::move(other);
+    }
+
+    MappedMaze& MappedMaze::operator=(MappedMaze&& other) {
+        if(this != &other) {
+            close();
+            theDims = other.theDims;
+            theSeed = other.theSeed;
+            theBegin = other.theBegin;
+            theEnd = other.theEnd;
+            thePayload = other.thePayload;
+            theMapping = std::exchange(other.theMapping, nullptr);
+            theMappingSize = std::exchange(other.theMappingSize, 0);
+            theFallback = std::move(other.theFallback);
+            other.thePayload = nullptr;
+        }
+        return *this;
+    }
+
+    MappedMaze::~MappedMaze() {
+        close();
+    }
+
+    void MappedMaze::close() {
+#ifdef MAZY_HAS_MMAP
+        if(theMapping) {
+            ::munmap(theMapping, theMappingSize);
+        }
+#endif
+        theMapping = nullptr;
+        theMappingSize = 0;
+        theFallback.clear();
+        thePayload = nullptr;
+    }
+
+    validate::Result MappedMaze::open(const std::string& path) {
+        close();
+        const unsigned char* data = nullptr;
+        std::size_t size = 0;
+#ifdef MAZY_HAS_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        struct stat info;
+        if(fd >= 0 && ::fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* mapping = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+            if(mapping != MAP_FAILED) {
+                theMapping = mapping;
+                theMappingSize = static_cast<std::size_t>(info.st_size);
+                data = static_cast<const unsigned char*>(mapping);
+                size = theMappingSize;
+            }
+        }
+        if(fd >= 0) {
+            ::close(fd);
+        }
+#endif
+        if(not data) {
+            std::ifstream file(path, std::ios::binary);
+            theFallback.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            data = theFallback.data();
+            size = theFallback.size();
+        }
+
+        if(size < BINARY_HEADER_SIZE || std::memcmp(data, "MAZY", 4) != 0
+           || get<std::uint16_t>(data + 4) != BINARY_VERSION) {
+            utils::errorMsg("Not a binary maze (version ") << BINARY_VERSION << "): " << path << std::endl;
+            close();
+            return validate::Result::NOK;
+        }
+        auto headerSize = get<std::uint16_t>(data + 6);
+        theDims = {get<std::uint32_t>(data + 8), get<std::uint32_t>(data + 12)};
+        theSeed = get<std::uint64_t>(data + 16);
+        theBegin = {get<std::uint32_t>(data + 24), get<std::uint32_t>(data + 28)};
+        theEnd = {get<std::uint32_t>(data + 32), get<std::uint32_t>(data + 36)};
+        auto tiles = std::size_t(theDims.x) * theDims.y;
+        auto outside = [this](const Coordinates& c) {
+            return c.x != NO_TILE && (c.x >= theDims.x || c.y >= theDims.y);
+        };
+        if(   headerSize < BINARY_HEADER_SIZE || size < headerSize + (tiles + 7) / 8
+           || outside(theBegin) || outside(theEnd)) {
+            utils::errorMsg("Truncated binary maze: ") << path << std::endl;
+            close();
+            return validate::Result::NOK;
+        }
+        thePayload = data + headerSize;
+        return validate::Result::OK;
+    }
+
+    char MappedMaze::operator[](const Coordinates& coord) const {
+        if(coord.x == theBegin.x && coord.y == theBegin.y) {
+            return BEGIN;
+        }
+        if(coord.x == theEnd.x && coord.y == theEnd.y) {
+            return END;
+        }
+        return isWall(coord) ? WALL : EMPTY;
+    }
+
+    Maze MappedMaze::toMaze() const {
+        Maze maze(theDims);
+        for(unsigned int y = 0; y < theDims.y; ++y) {
+            char* row = maze.row(y);
+            for(unsigned int x = 0; x < theDims.x; ++x) {
+                row[x] = isWall({x, y}) ? WALL : EMPTY;
+            }
+        }
+        for(auto [coord, tile] : {std::make_pair(theBegin, BEGIN), std::make_pair(theEnd, END)}) {
+            if(coord.x != NO_TILE) {
+                maze[coord] = tile;
+            }
+        }
+        return maze;
+    }
+}
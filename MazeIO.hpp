@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Utils.hpp"
+#include "Validators.hpp"
+
+struct Maze;
+
+
+namespace io {
+    /// Write the maze as text to `path`, in one copy into a memory-mapped file where available.
+    validate::Result writeText(const Maze& maze, const std::string& path);
+
+    /**
+     * Binary format, all numbers little-endian:
+     *   "MAZY", u16 version, u16 header size, u32 width, u32 height, u64 seed,
+     *   u32 begin x, u32 begin y, u32 end x, u32 end y (NO_TILE if the maze has none),
+     * then one bit per tile, row after row without padding, least significant bit first; 1 = wall.
+     */
+    const std::uint16_t BINARY_VERSION = 1;
+    const std::size_t BINARY_HEADER_SIZE = 40;
+    const std::uint32_t NO_TILE = 0xffffffff;
+
+    /// Bytes the maze takes in the binary format.
+    std::size_t binarySize(const Maze& maze);
+
+    /// Encode the maze in the binary format into the binarySize(maze) bytes at `out`.
+    void encodeBinary(const Maze& maze, std::uint64_t seed, char* out);
+
+    /// Write the maze in the binary format, about 1/8 of the size of the text.
+    validate::Result writeBinary(const Maze& maze, std::uint64_t seed, const std::string& path);
+
+    /**
+     * A binary maze file, mapped into memory rather than read. Tiles are looked up straight in
+     * the file's bits, so opening even a huge maze costs next to nothing.
+     */
+    class MappedMaze {
+    public:
+        MappedMaze() = default;
+        MappedMaze(MappedMaze&& other);
+        MappedMaze& operator=(MappedMaze&& other);
+        ~MappedMaze();
+
+        validate::Result open(const std::string& path);
+
+        const Dimensions& dims() const { return theDims; }
+        std::uint64_t seed() const { return theSeed; }
+        const Coordinates& begin() const { return theBegin; }
+        const Coordinates& end() const { return theEnd; }
+
+        bool isWall(const Coordinates& coord) const {
+            auto bit = std::size_t(coord.y) * theDims.x + coord.x;
+            return (thePayload[bit / 8] >> (bit % 8)) & 1;
+        }
+
+        /// The tile as it would be in the Maze: WALL, EMPTY, BEGIN or END.
+        char operator[](const Coordinates& coord) const;
+
+        /// Decode the whole file into a regular maze.
+        Maze toMaze() const;
+
+    private:
+        void close();
+
+        Dimensions theDims{0, 0};
+        std::uint64_t theSeed = 0;
+        Coordinates theBegin{NO_TILE, NO_TILE};
+        Coordinates theEnd{NO_TILE, NO_TILE};
+
+        const unsigned char* thePayload = nullptr;
+        void* theMapping = nullptr;
+        std::size_t theMappingSize = 0;
+        std::vector<unsigned char> theFallback;   // the file's contents, where it can't be mapped
+    };
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+
+/// How thoroughly each maze is checked before it's output.
+enum class Validation {
+    OFF,
+    CHEAP,      ///< only the linear 2x2 cluster scan
+    FULL        ///< also the traversal flood fill, and the distance of B and E if one was asked for
+};
+
+
+/// Everything the command line can ask for.
+struct Options {
+    int x = 0;
+    int y = 0;
+    std::optional<std::uint64_t> seed;
+    std::size_t batch = 1;      ///< number of mazes; with more than one, `seed` is the seed base
+    unsigned threads = 0;       ///< 0: one per core
+    unsigned tileSize = 0;      ///< 0: generate in one piece, otherwise in tiles of about this size
+    std::string outputPath;     ///< empty: print the maze to stdout
+    bool binary = false;        ///< write the output file in the compact binary format
+    bool farEndpoints = false;  ///< put B and E about as far apart as the maze allows
+    std::size_t minDistance = 0; ///< 0: any, otherwise the fewest steps allowed between B and E
+    std::string solver;         ///< empty: don't solve, otherwise bfs, astar or bidir
+    std::string algorithm = "growth";   ///< how the paths are drawn, see carve::algorithmFromName
+    std::size_t bestOf = 1;     ///< candidates generated for the one maze, the highest scoring one kept
+    std::string metric = "path-length";   ///< what the candidates are scored by, see analytics::metricFromName
+    Validation validation = Validation::FULL;
+    std::string statsPath;      ///< empty: no report, otherwise where the JSON statistics go
+    bool serve = false;         ///< answer maze requests instead of generating one maze (x and y unused)
+    std::string socketPath;     ///< empty: serve stdin/stdout, otherwise a Unix domain socket
+    std::size_t queueLength = 64;   ///< requests generated at once while serving
+    std::uint64_t maxTiles = 1 << 24;   ///< the most width x height a request to the server may ask for
+    bool stream = false;        ///< write the maze while it's generated, holding only a band of rows
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+
+/**
+ * 64-bit random engines for the generator. All of them satisfy UniformRandomBitGenerator and
+ * can be constructed from a single 64-bit seed, so any of them (or std::mt19937_64) can be
+ * plugged into BasicRandomCoordinateGenerator / BasicMazeCreator.
+ */
+namespace rng {
+
+/// Counter-based: the output is a bijective mix of an incrementing counter.
+class SplitMix64 {
+public:
+    using result_type = std::uint64_t;
+
+    explicit SplitMix64(std::uint64_t seed) : state(seed) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        std::uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    std::uint64_t state;
+};
+
+/// xoshiro256** by Blackman and Vigna; seeded through SplitMix64 as its authors recommend.
+class Xoshiro256StarStar {
+public:
+    using result_type = std::uint64_t;
+
+    explicit Xoshiro256StarStar(std::uint64_t seed) {
+        SplitMix64 seeder(seed);
+        for(auto& word : s) {
+            word = seeder();
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        const std::uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const std::uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    std::uint64_t s[4];
+};
+
+using DefaultEngine = Xoshiro256StarStar;
+
+/// Seed of the stream-th independent stream derived from `base` (the stream-th SplitMix64 output).
+inline std::uint64_t streamSeed(std::uint64_t base, std::uint64_t stream) {
+    return SplitMix64(base + stream * 0x9e3779b97f4a7c15ull)();
+}
+
+}
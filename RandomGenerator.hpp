@@ -1,39 +1,129 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
+#include <limits>
 #include <random>
 
 #include "Maze.hpp"
+#include "RandomEngines.hpp"
+#include "Stats.hpp"
+
+/**
+ * Hands out the random decisions of the generator. The engine's 64-bit words are buffered,
+ * so a coin flip costs one bit and a small pick costs 32 bits instead of a full draw each.
+ */
+template<typename Engine = rng::DefaultEngine>
+class BasicRandomCoordinateGenerator {
+    static_assert(Engine::min() == 0 && Engine::max() == std::numeric_limits<std::uint64_t>::max(),
+                  "The generator needs an engine producing full 64-bit words");
 
-class RandomCoordinateGenerator {
 public:
-    RandomCoordinateGenerator(const BoundingBox& bb)
-            : seed(std::chrono::system_clock::now().time_since_epoch().count()
-                   % reinterpret_cast<unsigned long long>(this)
-                   + std::random_device{}())
-            , gen{static_cast<unsigned int>(seed)}
-            , xGen(bb.tl.x, bb.br.x)
-            , yGen(bb.tl.y, bb.br.y)
-            , pathChoice(0, 3) {
+    /// The same seed always yields the same sequence, so a maze can be regenerated from it.
+    BasicRandomCoordinateGenerator(const BoundingBox& bb, std::uint64_t seed)
+            : seed(seed)
+            , gen(seed)
+            , xLow(bb.tl.x)
+            , xRange(bb.br.x - bb.tl.x + 1)
+            , yLow(bb.tl.y)
+            , yRange(bb.br.y - bb.tl.y + 1) {
+    }
+
+    BasicRandomCoordinateGenerator(const BoundingBox& bb)
+            : BasicRandomCoordinateGenerator(bb, entropySeed()) {
+    }
+
+    /// A fresh, non-reproducible seed for when the caller doesn't provide one.
+    static std::uint64_t entropySeed() {
+        std::random_device device;
+        return (std::uint64_t(std::chrono::system_clock::now().time_since_epoch().count()) << 32)
+               ^ (std::uint64_t(device()) << 32 | device());
+    }
+
+    std::uint64_t getSeed() const {
+        return seed;
+    }
+
+    /// Words taken from the engine so far; always 0 with the stats compiled out.
+    std::uint64_t draws() const {
+        return drawn;
     }
 
     Coordinates getRandomCoordinate() {
-        return { xGen(gen), yGen(gen) };
+        return { xLow + pickRandomFrom(xRange), yLow + pickRandomFrom(yRange) };
     }
 
     bool coinFlip() {
-        return pathChoice(gen) % 2;
+        if(coinBitsLeft == 0) {
+            coinBits = draw();
+            coinBitsLeft = 64;
+        }
+        bool result = coinBits & 1;
+        coinBits >>= 1;
+        --coinBitsLeft;
+        return result;
     }
 
+    /// Uniform in [0, number), using Lemire's multiply-shift with rejection of the biased tail.
     unsigned pickRandomFrom(unsigned int number) {
-        return std::uniform_int_distribution<unsigned int>(0, number - 1)(gen);
+        std::uint64_t product = std::uint64_t(next32()) * number;
+        auto low = static_cast<std::uint32_t>(product);
+        if(low < number) {
+            const std::uint32_t threshold = -number % number;
+            while(low < threshold) {
+                product = std::uint64_t(next32()) * number;
+                low = static_cast<std::uint32_t>(product);
+            }
+        }
+        return static_cast<unsigned>(product >> 32);
+    }
+
+    /// Uniform in [0, number) for counts that may not fit 32 bits; the same draws as pickRandomFrom() where they do.
+    std::uint64_t pickRandomIndex(std::uint64_t number) {
+        if(number <= std::numeric_limits<std::uint32_t>::max()) {
+            return pickRandomFrom(static_cast<unsigned>(number));
+        }
+        const std::uint64_t threshold = -number % number;   // words below it would favour the low indices
+        std::uint64_t word;
+        do {
+            word = draw();
+        }
+        while(word < threshold);
+        return word % number;
     }
 
 private:
-    unsigned long long seed;
-    std::mt19937 gen;
+    std::uint64_t draw() {
+        if constexpr(stats::ENABLED) {
+            ++drawn;
+        }
+        return gen();
+    }
+
+    std::uint32_t next32() {
+        if(hasSpareHalf) {
+            hasSpareHalf = false;
+            return static_cast<std::uint32_t>(spareHalf);
+        }
+        auto word = draw();
+        spareHalf = word >> 32;
+        hasSpareHalf = true;
+        return static_cast<std::uint32_t>(word);
+    }
+
+    std::uint64_t seed;
+    Engine gen;
+
+    std::uint64_t coinBits = 0;
+    unsigned coinBitsLeft = 0;
+    std::uint64_t spareHalf = 0;
+    bool hasSpareHalf = false;
+    std::uint64_t drawn = 0;
+
+    unsigned int xLow;
+    unsigned int xRange;
+    unsigned int yLow;
+    unsigned int yRange;
+};
 
-    std::uniform_int_distribution<unsigned int> xGen;
-    std::uniform_int_distribution<unsigned int> yGen;
-    std::uniform_int_distribution<unsigned int> pathChoice;
-};
\ No newline at end of file
+using RandomCoordinateGenerator = BasicRandomCoordinateGenerator<>;
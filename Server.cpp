@@ -0,0 +1,397 @@
+#include "Server.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <istream>
+#include <list>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
+#include <string_view>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAZY_HAS_SOCKETS
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "FixedMazeCreator.hpp"
+#include "Maze.hpp"
+#include "MazeIO.hpp"
+#include "RandomEngines.hpp"
+#include "ThreadPool.hpp"
+#include "Utils.hpp"
+
+
+namespace server {
+    namespace {
+    std::vector<std::string_view> words(std::string_view line) {
+        std::vector<std::string_view> result;
+        while(true) {
+            auto first = line.find_first_not_of(" \t\r");
+            if(first == std::string_view::npos) {
+                return result;
+            }
+            line.remove_prefix(first);
+            auto length = std::min(line.find_first_of(" \t\r"), line.size());
+            result.push_back(line.substr(0, length));
+            line.remove_prefix(length);
+        }
+    }
+    }
+
+    Server::Server(ThreadPool& pool, std::size_t queueLength, std::uint64_t maxTiles)
+            : thePool(pool)
+            , theQueueLength(std::max<std::size_t>(1, queueLength))
+            , theMaxTiles(maxTiles)
+            , theSeedBase(RandomCoordinateGenerator::entropySeed())
+            , theCreators(pool.size())
+            , theResponses(theQueueLength) {
+    }
+
+    void Server::serve(std::istream& in, std::ostream& out) {
+        std::string line;
+        std::vector<std::string> lines(theQueueLength);
+        std::vector<std::string> responses(theQueueLength);   // swapped with theResponses, buffers and all
+        while(true) {
+            // Block for one request, then take whatever else has already arrived.
+            std::size_t count = 0;
+            while(   count < theQueueLength
+                  && (count == 0 || in.rdbuf()->in_avail() > 0)
+                  && std::getline(in, line)) {
+                if(line.find_first_not_of(" \t\r") != std::string::npos) {
+                    lines[count++].swap(line);
+                }
+            }
+            if(count == 0) {
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(theMutex);
+                theRequests.clear();
+                for(std::size_t i = 0; i < count; ++i) {
+                    theRequests.push_back(parse(lines[i]));
+                }
+                thePool.parallelFor(count, [&](std::size_t i, unsigned worker) {
+                    // The pool can't let an exception through, and one request must not end the others.
+                    try {
+                        answer(theRequests[i], theResponses[i], worker);
+                    } catch(const std::bad_alloc&) {
+                        theCreators[worker].reset();
+                        std::string().swap(theResponses[i]);
+                        theResponses[i] = "error out of memory\n";
+                    } catch(const std::exception& e) {
+                        theCreators[worker].reset();
+                        theResponses[i] = std::string("error ") + e.what() + "\n";
+                    }
+                });
+                for(std::size_t i = 0; i < count; ++i) {
+                    theResponses[i].swap(responses[i]);
+                }
+            }
+            for(std::size_t i = 0; i < count; ++i) {
+                out.write(responses[i].data(), static_cast<std::streamsize>(responses[i].size()));
+            }
+            out.flush();
+            if(not out) {
+                return;
+            }
+        }
+    }
+
+    Server::Request Server::parse(const std::string& line) {
+        Request request;
+        auto tokens = words(line);
+        std::optional<std::uint64_t> x, y, seed;
+        if(tokens.size() >= 2) {
+            x = utils::convertToUnsigned(tokens[0]);
+            y = utils::convertToUnsigned(tokens[1]);
+        }
+        std::size_t next = 2;
+        if(tokens.size() > next && tokens[next] != "text" && tokens[next] != "binary") {
+            seed = utils::convertToUnsigned(tokens[next++]);
+            if(not seed) {
+                request.error = "the seed needs to be a non-negative number";
+            }
+        }
+        if(tokens.size() > next) {
+            request.binary = tokens[next] == "binary";
+            if(tokens[next] != "text" && not request.binary) {
+                request.error = "the format needs to be text or binary";
+            }
+            ++next;
+        }
+
+        if(not x || not y || *x > 1u << 20 || *y > 1u << 20 || tokens.size() > next) {
+            request.error = "expected <width> <height> [seed] [text|binary]";
+        } else {
+            request.dims = {static_cast<unsigned>(*x), static_cast<unsigned>(*y)};
+            if(*x * *y > theMaxTiles) {
+                request.error = "the maze is larger than " + std::to_string(theMaxTiles) + " tiles";
+            } else if(*x < 3 || *y < 3 || (*x - 2) * (*y - 2) < 2) {
+                // The command line's size checks, without their log line: a client mustn't fill the log.
+                request.error = "the maze is too small, it needs room for B and E inside its border";
+            }
+        }
+        // Drawn even for bad requests, so a request's seed doesn't depend on the ones before it failing.
+        auto fallbackSeed = rng::streamSeed(theSeedBase, theRequestCount++);
+        request.seed = seed.value_or(fallbackSeed);
+        return request;
+    }
+
+    void Server::answer(const Request& request, std::string& response, unsigned worker) {
+        if(not request.error.empty()) {
+            response = "error " + request.error + "\n";
+            return;
+        }
+
+        auto header = [&](std::size_t size) {
+            return "ok " + std::to_string(request.dims.x) + " " + std::to_string(request.dims.y) + " "
+                   + std::to_string(request.seed) + " " + std::to_string(size) + "\n";
+        };
+        if(not request.binary && fixed::isHotSize(request.dims)) {   // the common sizes skip the dynamic grid
+            response = header((std::size_t(request.dims.x) + 1) * request.dims.y);
+            fixed::appendText(request.dims, request.seed, response);
+            return;
+        }
+
+        auto& creator = theCreators[worker];
+        if(creator) {
+            creator->reset(request.dims, request.seed);
+        } else {
+            creator.emplace(Dimensions(request.dims), request.seed);
+        }
+        creator->create();
+
+        const auto& maze = creator->result();
+        auto size = request.binary ? io::binarySize(maze) : maze.text().size();
+        response = header(size);
+        auto headerSize = response.size();
+        if(request.binary) {
+            response.resize(headerSize + size);
+            io::encodeBinary(maze, request.seed, response.data() + headerSize);
+        } else {
+            response.append(maze.text());
+        }
+    }
+
+#ifdef MAZY_HAS_SOCKETS
+    namespace {
+    /// Buffered stream access to a connected socket.
+    class SocketBuffer : public std::streambuf {
+    public:
+        explicit SocketBuffer(int fd) : fd(fd), input(1 << 16), output(1 << 16) {
+            setg(input.data(), input.data(), input.data());
+            setp(output.data(), output.data() + output.size());
+        }
+
+        ~SocketBuffer() override {
+            sync();
+        }
+
+    protected:
+        int_type underflow() override {
+            ssize_t count;
+            do {
+                count = ::read(fd, input.data(), input.size());
+            } while(count < 0 && errno == EINTR);
+            if(count <= 0) {
+                return traits_type::eof();
+            }
+            setg(input.data(), input.data(), input.data() + count);
+            return traits_type::to_int_type(*gptr());
+        }
+
+        int_type overflow(int_type c) override {
+            if(sync() != 0) {
+                return traits_type::eof();
+            }
+            if(not traits_type::eq_int_type(c, traits_type::eof())) {
+                *pptr() = traits_type::to_char_type(c);
+                pbump(1);
+            }
+            return traits_type::not_eof(c);
+        }
+
+        /// Large mazes go straight to the socket instead of through the buffer.
+        std::streamsize xsputn(const char* data, std::streamsize count) override {
+            if(count < epptr() - pptr()) {
+                std::memcpy(pptr(), data, static_cast<std::size_t>(count));
+                pbump(static_cast<int>(count));
+                return count;
+            }
+            if(sync() != 0 || not writeAll(data, static_cast<std::size_t>(count))) {
+                return 0;
+            }
+            return count;
+        }
+
+        int sync() override {
+            bool written = writeAll(pbase(), static_cast<std::size_t>(pptr() - pbase()));
+            setp(output.data(), output.data() + output.size());
+            return written ? 0 : -1;
+        }
+
+    private:
+        bool writeAll(const char* data, std::size_t count) {
+            while(count) {
+                auto written = ::write(fd, data, count);
+                if(written < 0 && errno == EINTR) {
+                    continue;
+                }
+                if(written <= 0) {
+                    return false;
+                }
+                data += written;
+                count -= static_cast<std::size_t>(written);
+            }
+            return true;
+        }
+
+        int fd;
+        std::vector<char> input;
+        std::vector<char> output;
+    };
+
+    /**
+     * The connections being served, each on a thread of its own. The threads are joined and
+     * their sockets closed here, by the listening thread, so a socket is never closed while its
+     * thread could still use it.
+     */
+    class Connections {
+    public:
+        explicit Connections(Server& server)
+                : theServer(server) {
+        }
+
+        /// Shuts the open connections down, so their threads end without waiting for the clients.
+        ~Connections() {
+            {
+                std::lock_guard<std::mutex> lock(theMutex);
+                for(auto& connection : theConnections) {
+                    if(not connection.done) {
+                        ::shutdown(connection.fd, SHUT_RDWR);
+                    }
+                }
+            }
+            for(auto& connection : theConnections) {
+                connection.thread.join();
+                ::close(connection.fd);
+            }
+        }
+
+        /// Wait until fewer than MAX_CONNECTIONS are open; the finished ones are cleaned up.
+        void waitForRoom() {
+            std::unique_lock<std::mutex> lock(theMutex);
+            theFinished.wait(lock, [this] { return theOpen < MAX_CONNECTIONS; });
+            for(auto it = theConnections.begin(); it != theConnections.end();) {
+                if(it->done) {
+                    it->thread.join();   // it's past its last use of the list
+                    ::close(it->fd);
+                    it = theConnections.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        void serve(int fd) {
+            std::lock_guard<std::mutex> lock(theMutex);
+            auto& connection = theConnections.emplace_back();
+            connection.fd = fd;
+            ++theOpen;
+            connection.thread = std::thread([this, &connection] {
+                {
+                    SocketBuffer buffer(connection.fd);
+                    std::istream in(&buffer);
+                    std::ostream out(&buffer);
+                    theServer.serve(in, out);
+                }
+                std::lock_guard<std::mutex> lock(theMutex);
+                connection.done = true;
+                --theOpen;
+                theFinished.notify_one();
+            });
+        }
+
+    private:
+        struct Connection {
+            int fd = -1;
+            bool done = false;
+            std::thread thread;
+        };
+
+        Server& theServer;
+        std::list<Connection> theConnections;   // stable, the threads hold on to their entries
+        unsigned theOpen = 0;
+        std::mutex theMutex;
+        std::condition_variable theFinished;
+    };
+    }
+
+    validate::Result listen(const std::string& path, Server& server) {
+        sockaddr_un address{};
+        if(path.size() >= sizeof(address.sun_path)) {
+            utils::errorMsg("Socket path too long: " + path);
+            return validate::Result::NOK;
+        }
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+        // Only a socket left behind by an earlier server is replaced, never any other file.
+        struct stat existing{};
+        if(::lstat(path.c_str(), &existing) == 0) {
+            if(not S_ISSOCK(existing.st_mode)) {
+                utils::errorMsg("Not replacing " + path + ", it isn't a socket");
+                return validate::Result::NOK;
+            }
+            ::unlink(path.c_str());
+        }
+
+        int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if(   listener < 0
+           || ::bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+           || ::listen(listener, 16) != 0) {
+            utils::errorMsg("Could not listen on " + path);
+            if(listener >= 0) {
+                ::close(listener);
+            }
+            return validate::Result::NOK;
+        }
+        std::signal(SIGPIPE, SIG_IGN);   // a client leaving early must not end the server
+
+        Connections connections(server);
+        while(true) {
+            connections.waitForRoom();
+            int connection = ::accept(listener, nullptr, nullptr);
+            if(connection < 0) {
+                if(errno == EINTR) {
+                    continue;
+                }
+                utils::errorMsg("Could not accept a connection on " + path);
+                ::close(listener);
+                return validate::Result::NOK;
+            }
+            // An idle client only holds its own thread, and not for longer than the timeout.
+            timeval timeout{};
+            timeout.tv_sec = IDLE_TIMEOUT_SECONDS;
+            ::setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            connections.serve(connection);
+        }
+    }
+#else
+    validate::Result listen(const std::string& path, Server&) {
+        utils::errorMsg("Unix domain sockets are not available here, can't listen on " + path);
+        return validate::Result::NOK;
+    }
+#endif
+}
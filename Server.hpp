@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "MazeCreator.hpp"
+#include "Validators.hpp"
+
+class ThreadPool;
+
+
+namespace server {
+    /**
+     * Answers maze requests, one per line:
+     *   <width> <height> [seed] [text|binary]
+     * with, in the order they were asked for,
+     *   ok <width> <height> <seed> <size>\n followed by the maze in `size` bytes, or
+     *   error <reason>\n
+     * Whatever has arrived, up to `queueLength` requests, is generated at once on the pool; each
+     * worker keeps its own creator, so warm requests don't allocate beyond their responses.
+     * Mazes of more than `maxTiles` tiles are refused, and a request that fails anyway (e.g. runs
+     * out of memory) is answered with an error on its own, without taking the others down.
+     */
+    class Server {
+    public:
+        Server(ThreadPool& pool, std::size_t queueLength, std::uint64_t maxTiles);
+
+        /**
+         * Serve until `in` ends. Several streams can be served at once from different threads;
+         * their requests take turns on the pool, a queue at a time.
+         */
+        void serve(std::istream& in, std::ostream& out);
+
+    private:
+        struct Request {
+            Dimensions dims{0, 0};
+            std::uint64_t seed = 0;
+            bool binary = false;
+            std::string error;
+        };
+
+        Request parse(const std::string& line);
+        void answer(const Request& request, std::string& response, unsigned worker);
+
+        ThreadPool& thePool;
+        std::size_t theQueueLength;
+        std::uint64_t theMaxTiles;
+        std::uint64_t theSeedBase;
+        std::uint64_t theRequestCount = 0;
+        std::vector<std::optional<MazeCreator>> theCreators;   // one per worker
+        std::vector<Request> theRequests;
+        std::vector<std::string> theResponses;
+        std::mutex theMutex;   // guards everything above while a queue is generated
+    };
+
+    /// Seconds a connection may stay silent before the server hangs up on it.
+    const unsigned IDLE_TIMEOUT_SECONDS = 60;
+
+    /// Connections served at once; further clients wait in the socket's backlog.
+    const unsigned MAX_CONNECTIONS = 64;
+
+    /**
+     * Listen on a Unix domain socket at `path` and serve every connection from a thread of its
+     * own. Anything at `path` other than a socket left behind is left alone, and listening fails.
+     * If accepting fails, the open connections are shut down and their threads joined before
+     * this returns, so `server` is no longer used once it has.
+     */
+    validate::Result listen(const std::string& path, Server& server);
+}
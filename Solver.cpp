@@ -0,0 +1,206 @@
+#include "Solver.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <vector>
+
+#include "Maze.hpp"
+
+
+namespace solve {
+    namespace {
+    /// Per tile, the direction it was entered by (see dir::); start tiles are marked with START.
+    using Parents = std::vector<std::uint8_t>;
+    const std::uint8_t UNSEEN = 0xff;
+    const std::uint8_t START = dir::COUNT;
+
+    constexpr std::array<unsigned, dir::COUNT> OPPOSITE{
+        dir::S, dir::SE, dir::SW, dir::N, dir::NE, dir::NW, dir::E, dir::W
+    };
+    const char MOVES[] = "87921346";   // keypad digit of each direction, in dir:: order
+
+    bool isOpen(char tile) {
+        return tile != WALL;
+    }
+
+    /// The steps from `from` to `to`, read backwards through the parents.
+    std::string movesTo(const Maze& maze, const Parents& enteredBy, std::size_t from, std::size_t to) {
+        std::string moves;
+        for(auto idx = to; idx != from; idx = maze.neighbour(idx, OPPOSITE[enteredBy[idx]])) {
+            moves.push_back(MOVES[enteredBy[idx]]);
+        }
+        std::reverse(moves.begin(), moves.end());
+        return moves;
+    }
+
+    void bfs(const Maze& maze, std::size_t begin, std::size_t end, Solution& solution) {
+        Parents enteredBy(maze.array.size(), UNSEEN);
+        enteredBy[begin] = START;
+        std::vector<std::size_t> buffer;
+        utils::Fifo<std::size_t> queue(buffer);
+        queue.push(begin);
+        while(not queue.empty()) {
+            auto idx = queue.pop();
+            ++solution.expanded;
+            for(unsigned d = 0; d < dir::COUNT; ++d) {
+                auto neighbor = maze.neighbour(idx, d);
+                if(not isOpen(maze[neighbor]) || enteredBy[neighbor] != UNSEEN) {
+                    continue;
+                }
+                enteredBy[neighbor] = static_cast<std::uint8_t>(d);
+                if(neighbor == end) {
+                    solution.solved = true;
+                    solution.moves = movesTo(maze, enteredBy, begin, end);
+                    return;
+                }
+                queue.push(neighbor);
+            }
+        }
+    }
+
+    void aStar(const Maze& maze, std::size_t begin, std::size_t end, Solution& solution) {
+        auto target = maze.coordinates(end);
+        auto estimate = [&](std::size_t idx) {
+            auto coord = maze.coordinates(idx);
+            return std::max(coord.x > target.x ? coord.x - target.x : target.x - coord.x,
+                            coord.y > target.y ? coord.y - target.y : target.y - coord.y);
+        };
+
+        struct Node {
+            std::uint32_t estimate;   // cost so far plus the heuristic
+            std::uint32_t cost;
+            std::size_t idx;
+
+            /// Lowest estimate first; among equals the deepest, which is closest to the goal.
+            bool operator<(const Node& other) const {
+                return estimate != other.estimate ? estimate > other.estimate : cost < other.cost;
+            }
+        };
+
+        Parents enteredBy(maze.array.size(), UNSEEN);
+        std::vector<std::uint32_t> cost(maze.array.size(), std::numeric_limits<std::uint32_t>::max());
+        std::priority_queue<Node> open;
+        enteredBy[begin] = START;
+        cost[begin] = 0;
+        open.push({estimate(begin), 0, begin});
+        while(not open.empty()) {
+            auto node = open.top();
+            open.pop();
+            if(node.cost > cost[node.idx]) {   // reached more cheaply since it was queued
+                continue;
+            }
+            if(node.idx == end) {
+                solution.solved = true;
+                solution.moves = movesTo(maze, enteredBy, begin, end);
+                return;
+            }
+            ++solution.expanded;
+            for(unsigned d = 0; d < dir::COUNT; ++d) {
+                auto neighbor = maze.neighbour(node.idx, d);
+                if(isOpen(maze[neighbor]) && node.cost + 1 < cost[neighbor]) {
+                    cost[neighbor] = node.cost + 1;
+                    enteredBy[neighbor] = static_cast<std::uint8_t>(d);
+                    open.push({node.cost + 1 + estimate(neighbor), node.cost + 1, neighbor});
+                }
+            }
+        }
+    }
+
+    /**
+     * The frontiers grow a whole level at a time, so the first tile seen from both ends lies on a
+     * shortest path: any shorter one would have met in an earlier level.
+     */
+    void bidirectional(const Maze& maze, std::size_t begin, std::size_t end, Solution& solution) {
+        std::array<Parents, 2> enteredBy{Parents(maze.array.size(), UNSEEN), Parents(maze.array.size(), UNSEEN)};
+        std::array<std::vector<std::size_t>, 2> frontiers{std::vector<std::size_t>{begin}, std::vector<std::size_t>{end}};
+        std::vector<std::size_t> next;
+        enteredBy[0][begin] = START;
+        enteredBy[1][end] = START;
+
+        auto meet = maze.array.size();
+        while(meet == maze.array.size() && frontiers[0].size() && frontiers[1].size()) {
+            unsigned side = frontiers[0].size() <= frontiers[1].size() ? 0 : 1;
+            auto& seen = enteredBy[side];
+            next.clear();
+            for(std::size_t i = 0; i < frontiers[side].size() && meet == maze.array.size(); ++i) {
+                auto idx = frontiers[side][i];
+                ++solution.expanded;
+                for(unsigned d = 0; d < dir::COUNT; ++d) {
+                    auto neighbor = maze.neighbour(idx, d);
+                    if(not isOpen(maze[neighbor]) || seen[neighbor] != UNSEEN) {
+                        continue;
+                    }
+                    seen[neighbor] = static_cast<std::uint8_t>(d);
+                    if(enteredBy[1 - side][neighbor] != UNSEEN) {
+                        meet = neighbor;
+                        break;
+                    }
+                    next.push_back(neighbor);
+                }
+            }
+            frontiers[side].swap(next);
+        }
+        if(meet == maze.array.size()) {
+            return;
+        }
+
+        solution.solved = true;
+        solution.moves = movesTo(maze, enteredBy[0], begin, meet);
+        for(auto idx = meet; idx != end; ) {   // the end's side points back towards the end
+            auto back = OPPOSITE[enteredBy[1][idx]];
+            solution.moves.push_back(MOVES[back]);
+            idx = maze.neighbour(idx, back);
+        }
+    }
+    }
+
+    std::optional<Algorithm> algorithmFromName(const std::string& name) {
+        for(auto algorithm : {Algorithm::BFS, Algorithm::ASTAR, Algorithm::BIDIRECTIONAL}) {
+            if(name == solve::name(algorithm)) {
+                return algorithm;
+            }
+        }
+        return std::nullopt;
+    }
+
+    const char* name(Algorithm algorithm) {
+        switch(algorithm) {
+            case Algorithm::BFS: return "bfs";
+            case Algorithm::ASTAR: return "astar";
+            case Algorithm::BIDIRECTIONAL: return "bidir";
+        }
+        return "";
+    }
+
+    Solution shortestPath(const Maze& maze, Algorithm algorithm) {
+        Solution solution;
+        auto begin = std::find(maze.array.begin(), maze.array.end(), BEGIN);
+        auto end = std::find(maze.array.begin(), maze.array.end(), END);
+        if(begin == maze.array.end() || end == maze.array.end()) {
+            return solution;
+        }
+
+        auto beginIdx = static_cast<std::size_t>(begin - maze.array.begin());
+        auto endIdx = static_cast<std::size_t>(end - maze.array.begin());
+        solution.begin = maze.coordinates(beginIdx);
+        switch(algorithm) {
+            case Algorithm::BFS: bfs(maze, beginIdx, endIdx, solution); break;
+            case Algorithm::ASTAR: aStar(maze, beginIdx, endIdx, solution); break;
+            case Algorithm::BIDIRECTIONAL: bidirectional(maze, beginIdx, endIdx, solution); break;
+        }
+        return solution;
+    }
+
+    void overlay(Maze& maze, const Solution& solution) {
+        auto idx = maze.index(solution.begin);
+        for(auto move : solution.moves) {
+            idx = maze.neighbour(idx, static_cast<unsigned>(std::find(MOVES, MOVES + dir::COUNT, move) - MOVES));
+            if(maze[idx] != BEGIN && maze[idx] != END) {
+                maze[idx] = PATH;
+            }
+        }
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+#include "Utils.hpp"
+
+struct Maze;
+
+
+/**
+ * Shortest B-to-E paths, found straight on the Maze's buffer. Like the traversal check, a step
+ * may go in any of the 8 directions, so every step costs the same.
+ */
+namespace solve {
+    enum class Algorithm {
+        BFS,
+        ASTAR,          ///< guided by the Chebyshev distance, the 8-direction Manhattan distance
+        BIDIRECTIONAL   ///< BFS from both ends, always growing the smaller frontier
+    };
+
+    /// bfs, astar or bidir.
+    std::optional<Algorithm> algorithmFromName(const std::string& name);
+    const char* name(Algorithm algorithm);
+
+    /**
+     * One digit per step, laid out like a numeric keypad: 8 is north, 3 is south-east, and so on.
+     * Empty if the maze has no B or E, or they are not connected.
+     */
+    struct Solution {
+        bool solved = false;
+        Coordinates begin{0, 0};
+        std::string moves;
+        std::size_t expanded = 0;   ///< tiles whose neighbours were looked at
+    };
+
+    Solution shortestPath(const Maze& maze, Algorithm algorithm);
+
+    /// Mark the tiles of the solution between B and E as PATH.
+    void overlay(Maze& maze, const Solution& solution);
+}
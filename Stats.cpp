@@ -0,0 +1,54 @@
+#include "Stats.hpp"
+
+#include <algorithm>
+#include <ostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAZY_HAS_RUSAGE
+#include <sys/resource.h>
+#endif
+
+
+namespace stats {
+    namespace {
+    const char* const PHASE_NAMES[PHASE_COUNT] = {
+        "fillBorders", "drawPaths", "flip", "closeGaps", "dropEndpoints"
+    };
+    }
+
+    void Generation::addCounters(const Generation& other) {
+        drawRounds += other.drawRounds;
+        peakFrontier = std::max(peakFrontier, other.peakFrontier);
+        gapsChecked += other.gapsChecked;
+        wallsAdded += other.wallsAdded;
+        rngDraws += other.rngDraws;
+    }
+
+    std::size_t peakMemoryBytes() {
+#ifdef MAZY_HAS_RUSAGE
+        rusage usage{};
+        if(getrusage(RUSAGE_SELF, &usage) != 0) {
+            return 0;
+        }
+#ifdef __APPLE__
+        return static_cast<std::size_t>(usage.ru_maxrss);          // bytes
+#else
+        return static_cast<std::size_t>(usage.ru_maxrss) * 1024;   // kilobytes
+#endif
+#else
+        return 0;
+#endif
+    }
+
+    void writeJson(std::ostream& os, const Generation& generation) {
+        os << "{\"milliseconds\": {";
+        for(unsigned phase = 0; phase < PHASE_COUNT; ++phase) {
+            os << (phase ? ", " : "") << "\"" << PHASE_NAMES[phase] << "\": " << generation.milliseconds[phase];
+        }
+        os << "}, \"drawRounds\": " << generation.drawRounds
+           << ", \"peakFrontier\": " << generation.peakFrontier
+           << ", \"gapsChecked\": " << generation.gapsChecked
+           << ", \"wallsAdded\": " << generation.wallsAdded
+           << ", \"rngDraws\": " << generation.rngDraws << "}";
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+
+/**
+ * What the generator's phases cost. Building with -DMAZY_NO_STATS compiles the recording out:
+ * the timers and counters then cost nothing and every figure stays 0.
+ */
+namespace stats {
+#ifdef MAZY_NO_STATS
+    constexpr bool ENABLED = false;
+#else
+    constexpr bool ENABLED = true;
+#endif
+
+    enum Phase : unsigned { FILL_BORDERS = 0, DRAW_PATHS, FLIP, CLOSE_GAPS, DROP_ENDPOINTS, PHASE_COUNT };
+
+    struct Generation {
+        std::array<double, PHASE_COUNT> milliseconds{};   ///< wall time of each phase
+        std::uint64_t drawRounds = 0;       ///< rounds of drawPaths, each growing every active endpoint
+        std::size_t peakFrontier = 0;       ///< most endpoints drawPaths had to look after at once
+        std::uint64_t gapsChecked = 0;      ///< isolated wall pieces closeGaps' sweep found
+        std::uint64_t wallsAdded = 0;
+        std::uint64_t rngDraws = 0;         ///< 64-bit words taken from the random engines
+
+        /// Add the counters of work done elsewhere, e.g. on another tile; the times are left alone.
+        void addCounters(const Generation& other);
+    };
+
+    /// Run `phase` and add its wall time to `milliseconds`.
+    template<typename Func>
+    void timed(double& milliseconds, Func&& phase) {
+        if constexpr(ENABLED) {
+            auto start = std::chrono::steady_clock::now();
+            phase();
+            milliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        } else {
+            phase();
+        }
+    }
+
+    /// The most memory the process has held so far, 0 where the platform doesn't tell.
+    std::size_t peakMemoryBytes();
+
+    /// The figures as one JSON object.
+    void writeJson(std::ostream& os, const Generation& generation);
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Maze.hpp"
+#include "MazeCreator.hpp"
+#include "RandomEngines.hpp"
+#include "ThreadPool.hpp"
+#include "Utils.hpp"
+
+
+/**
+ * Generates a maze in bands of about tileSize rows and hands each band's rows on as soon as it's
+ * finished, so only two bands are ever held: memory grows with the width, but not the height.
+ * Each band is split into tiles like createTiled()'s, separated by wall seams with one door each,
+ * and every tile gets a door to the tile above it; that keeps the whole maze connected without
+ * tracking anything across bands. A band is only flipped and has its gaps closed once the band
+ * below it is drawn and the doors between them are open, which is all that needs both.
+ * The result depends on the seed, the dimensions and the tile size, but not on the pool; it is
+ * a different maze than create() or createTiled() make from the same seed.
+ */
+template<typename Engine = rng::DefaultEngine>
+class BasicStreamingCreator {
+public:
+    using Creator = BasicMazeCreator<Engine>;
+    using Random = typename Creator::Random;
+
+    BasicStreamingCreator(const Dimensions& dims, unsigned tileSize, std::uint64_t seed = Random::entropySeed())
+            : theDims(dims)
+            , theSeed(seed)
+            , theColumns(Creator::splitIntoTiles(1, dims.x - 2, std::max(4u, tileSize)))
+            , theBands(Creator::splitIntoTiles(1, dims.y - 2, std::max(4u, tileSize)))
+            , theWindow({dims.x, 3 + 2 * maxBandHeight()}, seed) {
+    }
+
+    /**
+     * Generate the maze and pass its text to `emit(const char* rows, std::size_t size)`, a few
+     * whole rows at a time, line breaks included; all of it is exactly what printing the maze gives.
+     * Returns false, with the maze cut short, if a band couldn't be stitched to the one above it
+     * even as a perfect maze (see drawBand()).
+     */
+    template<typename Emit>
+    bool create(ThreadPool& pool, Emit&& emit) {
+        auto& maze = theWindow.theMaze;
+        theWindow.theTileScratches.resize(pool.size());
+        theTop = 0;   // world row of the window's first row
+        theFallbackBands = 0;
+        maze.fill(EMPTY);
+        std::fill_n(maze.row(0), maze.width, WALL);
+        if(not drawBand(pool, 0)) {
+            return false;
+        }
+
+        for(std::size_t band = 0; band < theBands.size(); ++band) {
+            bool last = band + 1 == theBands.size();
+            if(not last && not drawBand(pool, band + 1)) {
+                return false;
+            }
+            finishBand(pool, band);
+            if(band == 0) {
+                maze[randomEmptyTile(band, 0)] = BEGIN;
+            }
+            if(last) {
+                maze[randomEmptyTile(band, 1)] = END;
+            }
+
+            // Everything down to the band's last row is final; the seam below it may still get doors.
+            unsigned rows = theBands[band].second - theTop + 1 + last;
+            emit(maze.row(0), rows * maze.stride);
+            if(not last) {
+                unsigned kept = theBands[band + 1].second - theBands[band].second + 1;
+                std::copy_n(maze.row(rows), kept * maze.stride, maze.row(0));
+                theTop = theBands[band].second + 1;
+            }
+        }
+        return true;
+    }
+
+    const Dimensions& dims() const {
+        return theDims;
+    }
+
+    std::uint64_t seed() const {
+        return theSeed;
+    }
+
+    /// Takes effect with the next create().
+    void useAlgorithm(carve::Algorithm algorithm) {
+        theWindow.useAlgorithm(algorithm);
+    }
+
+    /// Rows held at once, including the seams around the two bands.
+    unsigned windowHeight() const {
+        return theWindow.theMaze.height;
+    }
+
+    /// Of the last create()'s bands, the ones drawn as perfect mazes because no door fitted them.
+    std::size_t fallbackBands() const {
+        return theFallbackBands;
+    }
+
+    /// For tests: count the first `attempts` draws of every band as unstitched, so the fallback gets used.
+    void failStitching(unsigned attempts) {
+        theFailedAttempts = attempts;
+    }
+
+private:
+    /// Draws of a band from fresh seeds before it falls back to a perfect maze.
+    static constexpr unsigned MAX_ATTEMPTS = 16;
+
+    unsigned maxBandHeight() const {
+        unsigned height = 0;
+        for(const auto& band : theBands) {
+            height = std::max(height, band.second - band.first + 1);
+        }
+        return height;
+    }
+
+    BoundingBox tile(std::size_t band, std::size_t column) const {
+        return { {theColumns[column].first, theBands[band].first - theTop},
+                 {theColumns[column].second, theBands[band].second - theTop} };
+    }
+
+    std::uint64_t tileSeed(std::uint64_t attempt, std::size_t band, std::size_t column) const {
+        return rng::streamSeed(rng::streamSeed(theSeed, attempt), band * theColumns.size() + column);
+    }
+
+    /// Walls around the band's tiles, and the seam (or the bottom border) below it.
+    void frameBand(std::size_t band) {
+        auto& maze = theWindow.theMaze;
+        unsigned first = theBands[band].first - theTop;
+        unsigned last = theBands[band].second - theTop;
+        for(unsigned y = first; y <= last; ++y) {
+            auto row = maze.row(y);
+            std::fill_n(row, maze.width, EMPTY);
+            row[0] = WALL;
+            row[maze.width - 1] = WALL;
+            for(std::size_t c = 0; c + 1 < theColumns.size(); ++c) {
+                row[theColumns[c].second + 1] = WALL;
+            }
+        }
+        std::fill_n(maze.row(last + 1), maze.width, WALL);
+    }
+
+    /**
+     * Draw the band's tiles and open the doors between them and to the band above. A door that
+     * can't be placed (practically impossible for reasonable tile sizes) has the band drawn again
+     * from other seeds, since the rows above it may already be out. After MAX_ATTEMPTS of those,
+     * the band is drawn as Kruskal's perfect maze, which takes a door wherever the band above has
+     * a path in its last row; false if even that doesn't fit.
+     */
+    bool drawBand(ThreadPool& pool, std::size_t band) {
+        auto& maze = theWindow.theMaze;
+        auto& scratches = theWindow.theTileScratches;
+        auto algorithm = theWindow.theAlgorithm;
+        for(unsigned attempt = 0; attempt <= MAX_ATTEMPTS; ++attempt) {
+            bool fallback = attempt == MAX_ATTEMPTS;
+            frameBand(band);
+            theWindow.useAlgorithm(fallback ? carve::Algorithm::KRUSKAL : algorithm);
+            pool.parallelFor(theColumns.size(), [&](std::size_t c, unsigned worker) {
+                auto box = tile(band, c);
+                Random rand(box, tileSeed(attempt, band, c));
+                theWindow.drawPaths(box, rand, scratches[worker]);
+            });
+            theWindow.useAlgorithm(algorithm);
+
+            bool stitched = attempt >= theFailedAttempts || fallback;
+            unsigned first = theBands[band].first - theTop;
+            unsigned height = theBands[band].second - theBands[band].first + 1;
+            for(std::size_t c = 0; c < theColumns.size() && stitched; ++c) {
+                unsigned width = theColumns[c].second - theColumns[c].first + 1;
+                if(c + 1 < theColumns.size()) {
+                    stitched &= theWindow.openDoor(maze.index({theColumns[c].second + 1, first}), height,
+                                                   std::ptrdiff_t(maze.stride), 1);
+                }
+                if(band > 0) {
+                    stitched &= theWindow.openDoor(maze.index({theColumns[c].first, first - 1}), width,
+                                                   1, std::ptrdiff_t(maze.stride));
+                }
+            }
+            if(stitched) {
+                theFallbackBands += fallback;
+                return true;
+            }
+            if(band > 0) {   // the doors already opened in the seam above
+                std::fill_n(maze.row(first - 1) + 1, maze.width - 2, WALL);
+            }
+        }
+        return false;
+    }
+
+    void finishBand(ThreadPool& pool, std::size_t band) {
+        auto& scratches = theWindow.theTileScratches;
+        std::size_t tiles = theBands.size() * theColumns.size();
+        pool.parallelFor(theColumns.size(), [&](std::size_t c, unsigned worker) {
+            auto box = tile(band, c);
+            Random rand(box, rng::streamSeed(theSeed, tiles + band * theColumns.size() + c));
+            theWindow.flip(box);
+            theWindow.closeGaps(box, rand, scratches[worker]);
+        });
+    }
+
+    std::size_t randomEmptyTile(std::size_t band, std::uint64_t endpoint) {
+        const auto& maze = theWindow.theMaze;
+        BoundingBox box{ {1, theBands[band].first - theTop}, {theDims.x - 2, theBands[band].second - theTop} };
+        Random rand(box, rng::streamSeed(theSeed, 2 * theBands.size() * theColumns.size() + endpoint));
+        while(true) {
+            auto idx = maze.index(rand.getRandomCoordinate());
+            if(maze[idx] == EMPTY) {
+                return idx;
+            }
+        }
+    }
+
+    Dimensions theDims;
+    std::uint64_t theSeed;
+    std::vector<std::pair<unsigned, unsigned>> theColumns;
+    std::vector<std::pair<unsigned, unsigned>> theBands;   // rows of the maze, seams between them
+    Creator theWindow;   // its maze holds the rows from theTop on
+    unsigned theTop = 0;
+    std::size_t theFallbackBands = 0;
+    unsigned theFailedAttempts = 0;
+};
+
+using StreamingCreator = BasicStreamingCreator<>;
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/**
+ * A fixed set of worker threads that are started once and then fed loops. Each call of the
+ * loop body also gets the number of the worker running it, so callers can keep per-thread
+ * buffers without any locking. Loops are run one at a time.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads = 0) {
+        if(threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for(unsigned worker = 0; worker < threads; ++worker) {
+            workers.emplace_back([this, worker] { run(worker); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for(auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const {
+        return static_cast<unsigned>(workers.size());
+    }
+
+    /**
+     * Calls func(index, worker) for every index in [0, count) and waits until all are done.
+     * Calls from several threads at once take turns, since the workers hold one loop at a time;
+     * `func` itself must not call parallelFor() on the same pool.
+     */
+    template<typename Func>
+    void parallelFor(std::size_t count, Func&& func) {
+        std::lock_guard<std::mutex> turn(callers);
+        std::atomic<std::size_t> next{0};
+        std::unique_lock<std::mutex> lock(mutex);
+        job = [&](unsigned worker) {
+            for(auto index = next++; index < count; index = next++) {
+                func(index, worker);
+            }
+        };
+        busy = size();
+        ++generation;
+        wake.notify_all();
+        done.wait(lock, [this] { return busy == 0; });
+        job = nullptr;
+    }
+
+private:
+    void run(unsigned worker) {
+        std::uint64_t seenGeneration = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        while(true) {
+            wake.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if(stopping) {
+                return;
+            }
+            seenGeneration = generation;
+            lock.unlock();
+            job(worker);
+            lock.lock();
+            if(--busy == 0) {
+                done.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex callers;   // held for a whole loop, so a second caller waits for the first
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::function<void(unsigned)> job;
+    std::uint64_t generation = 0;
+    unsigned busy = 0;
+    bool stopping = false;
+};
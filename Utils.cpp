@@ -1,16 +1,28 @@
 #include "Utils.hpp"
 
+#include <charconv>
+#include <cstring>
 #include <iostream>
-#include <sstream>
 #include <tuple>
 
 
 namespace utils {
 int convertToInt(const char* s) {
-    std::stringstream  ss;
-    ss << s;
-    int i;
-    ss >> i;
+    int i = 0;
+    std::from_chars(s, s + std::strlen(s), i);
+    return i;
+}
+
+std::optional<std::uint64_t> convertToUnsigned(const char* s) {
+    return convertToUnsigned(std::string_view(s));
+}
+
+std::optional<std::uint64_t> convertToUnsigned(std::string_view s) {
+    std::uint64_t i = 0;
+    auto [end, error] = std::from_chars(s.data(), s.data() + s.size(), i);
+    if(error != std::errc() || end != s.data() + s.size()) {
+        return std::nullopt;
+    }
     return i;
 }
 
@@ -1,14 +1,59 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <optional>
+#include <string_view>
 #include <tuple>
+#include <type_traits>
 #include <vector>
 
 
 namespace utils {
 int convertToInt(const char* s);
 
+/// Empty if `s` is not entirely a non-negative number.
+std::optional<std::uint64_t> convertToUnsigned(const char* s);
+std::optional<std::uint64_t> convertToUnsigned(std::string_view s);
+
 std::ostream& errorMsg(const std::string& msg);
+
+/**
+ * The queue of a breadth-first sweep, kept in a vector it borrows, so the caller can keep the
+ * buffer from sweep to sweep. Once most of the vector has been taken, the taken part is dropped,
+ * which keeps it about as small as the sweep's wavefront.
+ */
+template<typename T>
+class Fifo {
+public:
+    explicit Fifo(std::vector<T>& items)
+            : theItems(items) {
+        theItems.clear();
+    }
+
+    bool empty() const {
+        return theHead == theItems.size();
+    }
+
+    void push(const T& item) {
+        theItems.push_back(item);
+    }
+
+    T pop() {
+        T item = theItems[theHead++];
+        if(theHead > 4096 && theHead * 2 > theItems.size()) {
+            theItems.erase(theItems.begin(), theItems.begin() + static_cast<std::ptrdiff_t>(theHead));
+            theHead = 0;
+        }
+        return item;
+    }
+
+private:
+    std::vector<T>& theItems;
+    std::size_t theHead = 0;
+};
 }
 
 struct Dimensions {
@@ -16,43 +61,62 @@ struct Dimensions {
     unsigned int y;
 };
 
+/// Neighbour directions, in the order of the NEIGHBOURS table.
+namespace dir {
+enum : unsigned { N = 0, NW, NE, S, SW, SE, W, E, COUNT };
+}
+
+struct Offset {
+    int dx;
+    int dy;
+};
+
+/// Shared neighbour table, so that walking the 8-neighbourhood needs no per-object state.
+constexpr std::array<Offset, dir::COUNT> NEIGHBOURS{{
+    {0, -1}, {-1, -1}, {1, -1},
+    {0, 1},  {-1, 1},  {1, 1},
+    {-1, 0}, {1, 0}
+}};
+
 struct Coordinates : Dimensions {
     Coordinates() = default;
-    Coordinates(unsigned int x, unsigned int y) : Dimensions{x, y} {}
+    constexpr Coordinates(unsigned int x, unsigned int y) : Dimensions{x, y} {}
+
+    constexpr Coordinates neighbour(unsigned direction) const {
+        return {x + NEIGHBOURS[direction].dx, y + NEIGHBOURS[direction].dy};
+    }
 
-    Coordinates n() const {
+    constexpr Coordinates n() const {
         return {x, y-1};
     }
-    Coordinates nw() const {
+    constexpr Coordinates nw() const {
         return {x-1, y-1};
     }
-    Coordinates ne() const {
+    constexpr Coordinates ne() const {
         return {x+1, y-1};
     }
-    Coordinates w() const {
+    constexpr Coordinates w() const {
         return {x-1, y};
     }
-    Coordinates e() const {
+    constexpr Coordinates e() const {
         return {x+1, y};
     }
-    Coordinates s() const {
+    constexpr Coordinates s() const {
         return {x, y+1};
     }
-    Coordinates sw() const {
+    constexpr Coordinates sw() const {
         return {x-1, y+1};
     }
-    Coordinates se() const {
+    constexpr Coordinates se() const {
         return {x+1, y+1};
     }
 
     bool operator<(const Coordinates& b) const {
         return std::tie(x,y) < std::tie(b.x,b.y);
     }
-
-    typedef Coordinates (Coordinates::*CoordFunc)() const;
-    std::vector<CoordFunc> directionFunctions = {Coordinates::n, Coordinates::nw, Coordinates::ne,
-                                                 Coordinates::s, Coordinates::sw, Coordinates::se,
-                                                 Coordinates::w, Coordinates::e};
 };
 
+static_assert(std::is_trivially_copyable_v<Coordinates> && sizeof(Coordinates) == 8,
+              "Coordinates are passed around by value in the hot loops");
+
 std::ostream& operator<<(std::ostream& os, const Coordinates& coord);
@@ -1,19 +1,26 @@
 #include "Validators.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
+#include "Algorithms.hpp"
+#include "Analytics.hpp"
+#include "Kernels.hpp"
 #include "Maze.hpp"
 #include "MazeCreator.hpp"
+#include "Options.hpp"
+#include "Solver.hpp"
 #include "Utils.hpp"
 
 
 std::ostream& operator<<(std::ostream& os, const Maze& maze) {
-    for(const auto& line : maze.array) {
-        for(char c : line) {
-            os << c;
-        }
-        os << std::endl;
-    }
+    auto text = maze.text();
+    os.write(text.data(), static_cast<std::streamsize>(text.size()));
     return os;
 }
 
@@ -25,21 +32,231 @@ std::ostream& operator<<(std::ostream& os, const MazeCreator& mc) {
 
 namespace validate {
 namespace input {
-    Result commandLineArguments(int argc) {
-        if(argc != 3) {
-            std::cout << "Usage:\n  exec x y\n\n  x = width of maze\n  y = height of maze"
-                      << std::endl;
+    namespace {
+    void printUsage() {
+        std::cout << "Usage:\n  exec --serve [--socket path] [--queue q] [--max-tiles k] [--threads t]\n  exec x y [--seed n] [--batch count] [--tile-size s] [--threads t]\n       [--out file [--format text|binary]] [--solve a]\n       [--far-endpoints] [--min-distance d] [--stats report]\n       [--validate off|cheap|full] [--algorithm g]\n       [--best-of c [--metric m]]\n  exec x y --stream [--seed n] [--tile-size s] [--threads t] [--out file]\n       [--validate off|cheap|full] [--algorithm g]\n\n"
+                     "  x = width of maze\n  y = height of maze"
+                     "\n  n = seed, the same seed and size always give the same maze"
+                     "\n  count = number of mazes to generate, n is then the seed base"
+                     "\n  s = generate one large maze in parallel, in tiles of about s x s (at least 4)"
+                     "\n  t = worker threads, all cores by default"
+                     "\n  file = write the maze there instead of printing it (file.<i> for a batch),"
+                     "\n         as text or in the binary format with one bit per tile"
+                     "\n  a = draw the shortest path from B to E, found with bfs, astar or bidir"
+                     "\n  d = fewest steps allowed from B to E; --far-endpoints puts them about as far"
+                     "\n      apart as the maze allows"
+                     "\n  g = how the paths are drawn: growth (the default, with loops), or the perfect"
+                     "\n      mazes of kruskal, wilson, backtracker or growing-tree"
+                     "\n  c = generate c candidates for the one maze and keep the one with the most m:"
+                     "\n      dead-ends, junctions, loops, path-length (the default) or branching"
+                     "\n  report = write what each phase of the generation took there, as JSON"
+                     "\n  path = serve requests on this Unix domain socket instead of stdin/stdout"
+                     "\n  q = requests to generate at once while serving (at least 1, 64 by default)"
+                     "\n  k = the most width x height a request may ask for (16777216 by default)"
+                     "\n  --stream = write the maze band by band while it's generated, holding only"
+                     "\n             about 2s rows (s is 64 by default); as text, one maze at a time"
+                     "\n  --validate = check each maze for 2x2 clusters only (cheap), also flood it (full,"
+                     "\n               the default) or not at all (off)"
+                  << std::endl;
+    }
+
+    /// Reads the value following the flag at argv[i] and steps over it.
+    std::optional<std::uint64_t> flagValue(int argc, const char* const* argv, int& i) {
+        if(i + 1 >= argc) {
+            return std::nullopt;
+        }
+        return utils::convertToUnsigned(argv[++i]);
+    }
+    }
+
+    Result commandLineArguments(int argc, const char* const* argv, Options& options) {
+        std::vector<const char*> positional;
+        for(int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if(arg.rfind("--", 0) != 0) {
+                positional.push_back(argv[i]);
+                continue;
+            }
+
+            if(arg == "--out") {
+                if(i + 1 >= argc) {
+                    utils::errorMsg("--out needs a file name!");
+                    return Result::NOK;
+                }
+                options.outputPath = argv[++i];
+                continue;
+            }
+            if(arg == "--stats") {
+                if(i + 1 >= argc) {
+                    utils::errorMsg("--stats needs a file name!");
+                    return Result::NOK;
+                }
+                options.statsPath = argv[++i];
+                continue;
+            }
+            if(arg == "--format") {
+                std::string format = i + 1 < argc ? argv[++i] : "";
+                if(format != "text" && format != "binary") {
+                    utils::errorMsg("--format needs to be text or binary!");
+                    return Result::NOK;
+                }
+                options.binary = format == "binary";
+                continue;
+            }
+            if(arg == "--algorithm") {
+                options.algorithm = i + 1 < argc ? argv[++i] : "";
+                if(not carve::algorithmFromName(options.algorithm)) {
+                    utils::errorMsg("--algorithm needs to be growth, kruskal, wilson, backtracker or growing-tree!");
+                    return Result::NOK;
+                }
+                continue;
+            }
+            if(arg == "--metric") {
+                options.metric = i + 1 < argc ? argv[++i] : "";
+                if(not analytics::metricFromName(options.metric)) {
+                    utils::errorMsg("--metric needs to be dead-ends, junctions, loops, path-length or branching!");
+                    return Result::NOK;
+                }
+                continue;
+            }
+            if(arg == "--solve") {
+                options.solver = i + 1 < argc ? argv[++i] : "";
+                if(not solve::algorithmFromName(options.solver)) {
+                    utils::errorMsg("--solve needs to be bfs, astar or bidir!");
+                    return Result::NOK;
+                }
+                continue;
+            }
+
+            if(arg == "--validate") {
+                std::string level = i + 1 < argc ? argv[++i] : "";
+                if(level == "off") {
+                    options.validation = Validation::OFF;
+                } else if(level == "cheap") {
+                    options.validation = Validation::CHEAP;
+                } else if(level == "full") {
+                    options.validation = Validation::FULL;
+                } else {
+                    utils::errorMsg("--validate needs to be off, cheap or full!");
+                    return Result::NOK;
+                }
+                continue;
+            }
+            if(arg == "--stream") {
+                options.stream = true;
+                continue;
+            }
+            if(arg == "--far-endpoints") {
+                options.farEndpoints = true;
+                continue;
+            }
+            if(arg == "--serve") {
+                options.serve = true;
+                continue;
+            }
+            if(arg == "--socket") {
+                if(i + 1 >= argc) {
+                    utils::errorMsg("--socket needs a path!");
+                    return Result::NOK;
+                }
+                options.serve = true;
+                options.socketPath = argv[++i];
+                continue;
+            }
+
+            std::optional<std::uint64_t> value;
+            if(arg == "--seed") {
+                value = options.seed = flagValue(argc, argv, i);
+            } else if(arg == "--batch") {
+                value = flagValue(argc, argv, i);
+                if(value == 0u) {
+                    value.reset();
+                }
+                options.batch = value.value_or(1);
+            } else if(arg == "--tile-size") {
+                value = flagValue(argc, argv, i);
+                // no tile is larger than a side, which fits an int
+                if(value < 4u || value > std::uint64_t(std::numeric_limits<int>::max())) {
+                    value.reset();
+                }
+                options.tileSize = static_cast<unsigned>(value.value_or(0));
+            } else if(arg == "--best-of") {
+                value = flagValue(argc, argv, i);
+                if(value == 0u) {
+                    value.reset();
+                }
+                options.bestOf = static_cast<std::size_t>(value.value_or(1));
+            } else if(arg == "--threads") {
+                value = flagValue(argc, argv, i);
+                if(value > std::numeric_limits<unsigned>::max()) {
+                    value.reset();
+                }
+                options.threads = static_cast<unsigned>(value.value_or(0));
+            } else if(arg == "--queue") {
+                value = flagValue(argc, argv, i);
+                if(value == 0u) {
+                    value.reset();
+                }
+                options.queueLength = static_cast<std::size_t>(value.value_or(1));
+            } else if(arg == "--max-tiles") {
+                value = flagValue(argc, argv, i);
+                if(value == 0u) {
+                    value.reset();
+                }
+                options.maxTiles = value.value_or(1);
+            } else if(arg == "--min-distance") {
+                value = flagValue(argc, argv, i);
+                options.minDistance = static_cast<std::size_t>(value.value_or(0));
+            } else {
+                printUsage();
+                return Result::NOK;
+            }
+            if(not value) {
+                utils::errorMsg(arg + " needs a non-negative number (batch, best-of, queue and max-tiles at least 1, tile size from 4 to 2147483647, threads at most 4294967295)!");
+                return Result::NOK;
+            }
+        }
+        if(options.serve && positional.empty()) {
+            return Result::OK;
+        }
+        if(positional.size() != 2) {
+            printUsage();
+            return Result::NOK;
+        }
+        options.x = utils::convertToInt(positional[0]);
+        options.y = utils::convertToInt(positional[1]);
+        if(   options.stream
+           && (   options.batch > 1 || options.binary || not options.solver.empty() || options.farEndpoints
+               || options.minDistance || not options.statsPath.empty())) {
+            utils::errorMsg("--stream can't be combined with --batch, --format binary, --solve, --far-endpoints,"
+                            " --min-distance or --stats!");
+            return Result::NOK;
+        }
+        if(options.binary && options.outputPath.empty()) {
+            utils::errorMsg("--format binary needs --out, a binary maze isn't printed!");
+            return Result::NOK;
+        }
+        if(options.binary && not options.solver.empty()) {
+            utils::errorMsg("--solve can't be combined with --format binary, which has no room for the drawn path!");
+            return Result::NOK;
+        }
+        if(options.batch > 1 && options.tileSize) {
+            utils::errorMsg("--batch can't be combined with --tile-size, the mazes of a batch are generated whole!");
+            return Result::NOK;
+        }
+        if(options.bestOf > 1 && (options.stream || options.batch > 1 || options.tileSize)) {
+            utils::errorMsg("--best-of can't be combined with --stream, --batch or --tile-size!");
             return Result::NOK;
         }
         return Result::OK;
     }
 
     namespace {
-    unsigned int mazeArea(const Dimensions& dims) {
+    std::uint64_t mazeArea(const Dimensions& dims) {
         if(dims.x < 2 || dims.y < 2) {
             return 0;
         }
-        return (dims.x - 2) * (dims.y - 2);
+        return std::uint64_t(dims.x - 2) * (dims.y - 2);
     }
     }
 
@@ -64,76 +281,126 @@ namespace input {
 namespace output {
     /// Check whether there are no 2x2 space tile clusters.
     Result noFreeClusters(const Maze& maze) {
-        for(unsigned int y = 1; y < maze.array.size() - 2; ++y) {
-            for(unsigned int x = 1; x < maze.array[y].size() - 2; ++x) {
-                if(maze.array[y][x] == ' '   && maze.array[y][x+1] == ' ' &&
-                   maze.array[y+1][x] == ' ' && maze.array[y+1][x+1] == ' ') {
-                    return Result::NOK;
-                }
+        for(unsigned int y = 1; y < maze.height - 2; ++y) {
+            if(kernels::hasFreeCluster(maze.row(y) + 1, maze.row(y + 1) + 1, maze.width - 2)) {
+                return Result::NOK;
             }
         }
         return Result::OK;
     }
 
-    struct ValidationAssistant {
-        ValidationAssistant(MazeCreator mc) : ref(mc) {}
-
-        auto forInnerBb(std::function<void(const Coordinates& c)> func) { return ref.forInnerBb(func); }
-        Maze& maze() { return ref.theMaze; }
-        RandomCoordinateGenerator& rand() { return ref.theRand; }
+    Result endpointsApart(const Maze& maze, std::size_t minDistance) {
+        auto solution = solve::shortestPath(maze, solve::Algorithm::BIDIRECTIONAL);
+        return solution.solved && solution.moves.size() >= minDistance ? Result::OK : Result::NOK;
+    }
 
-        MazeCreator ref;
-    };
+    namespace {
+    /// Anything but a wall can be walked on; only the tiles inside the frame are looked at.
+    bool isOpen(char tile) {
+        return tile != WALL;
+    }
 
-    // Using the creator to utilize some functionalities that make traversal easier
-    Result fullyTraversable(MazeCreator& mc) {
-        ValidationAssistant mca(mc);
+    template<typename Func>
+    void forInnerTiles(const Maze& maze, Func&& func) {
+        for(unsigned int y = 1; y + 1 < maze.height; ++y) {
+            auto rowStart = maze.index({0, y});
+            for(unsigned int x = 1; x + 1 < maze.width; ++x) {
+                func(rowStart + x);
+            }
+        }
+    }
+    }
 
-        mca.forInnerBb([&mca](const Coordinates& c) {
-            auto& tile = mca.maze()[c];
-            if(tile == BEGIN || tile == END) {
-                tile = EMPTY;
+    /**
+     * Flood from the first open tile over a flat queue, marking visits in a 1-bit-per-tile
+     * bitmap; the maze itself is not touched, so there's no need to copy it.
+     */
+    Result fullyTraversable(const Maze& maze) {
+        std::size_t openTiles = 0;
+        std::size_t start = maze.array.size();
+        forInnerTiles(maze, [&](std::size_t idx) {
+            if(isOpen(maze[idx])) {
+                start = std::min(start, idx);
+                ++openTiles;
             }
         });
-
-        auto start = mca.rand().getRandomCoordinate();
-        while(mca.maze()[start] != EMPTY) {
-            start = mca.rand().getRandomCoordinate();
+        if(openTiles == 0) {
+            return Result::OK;
         }
 
-        std::set<Coordinates> activeSeekers;
-        std::set<Coordinates> inactiveSeekers;
-        activeSeekers.insert(start);
-        while(activeSeekers.size()) {
-            for(auto seeker : activeSeekers) {
-                for(auto func : seeker.directionFunctions) {
-                    auto neighbor = (seeker.*func)();
-                    if(mca.maze()[neighbor] == EMPTY) {
-                        mca.maze()[neighbor] = PATH;
-                        activeSeekers.insert(neighbor);
-                    }
-                    inactiveSeekers.insert(seeker);
+        std::vector<bool> visited(maze.array.size(), false);
+        std::vector<std::size_t> buffer;
+        utils::Fifo<std::size_t> queue(buffer);
+        queue.push(start);
+        std::size_t reached = 1;
+        visited[start] = true;
+        while(not queue.empty()) {
+            auto idx = queue.pop();
+            for(unsigned d = 0; d < dir::COUNT; ++d) {
+                auto neighbor = maze.neighbour(idx, d);
+                if(isOpen(maze[neighbor]) && not visited[neighbor]) {
+                    visited[neighbor] = true;
+                    queue.push(neighbor);
+                    ++reached;
                 }
             }
-            for(auto rem : inactiveSeekers) {
-                activeSeekers.erase(rem);
+        }
+
+        if(reached == openTiles) {
+            return Result::OK;
+        }
+        std::size_t reported = 0;
+        forInnerTiles(maze, [&](std::size_t idx) {
+            if(isOpen(maze[idx]) && not visited[idx] && reported++ < 10) {
+                utils::errorMsg("Non-traverable tile found at ") << maze.coordinates(idx) << std::endl;
             }
-            inactiveSeekers.clear();
+        });
+        if(reported > 10) {
+            utils::errorMsg("...and ") << (reported - 10) << " more" << std::endl;
         }
+        return Result::NOK;
+    }
 
-        bool emptyTileFound = false;
-        mca.forInnerBb([&](const Coordinates& c){
-            if(mca.maze()[c] == EMPTY) {
-                emptyTileFound = true;
-                utils::errorMsg("Non-traverable tile found at ") << c << std::endl;
+    std::vector<Region> connectedRegions(const Maze& maze) {
+        std::vector<std::size_t> parent(maze.array.size());
+        auto find = [&parent](std::size_t idx) {
+            while(parent[idx] != idx) {
+                idx = parent[idx] = parent[parent[idx]];
+            }
+            return idx;
+        };
+
+        // Scanning row by row, the already labelled neighbours are W, NW, N and NE.
+        forInnerTiles(maze, [&](std::size_t idx) {
+            if(not isOpen(maze[idx])) {
+                return;
+            }
+            parent[idx] = idx;
+            for(unsigned d : {dir::W, dir::NW, dir::N, dir::NE}) {
+                auto neighbor = maze.neighbour(idx, d);
+                if(isOpen(maze[neighbor])) {
+                    auto a = find(idx);
+                    auto b = find(neighbor);
+                    parent[std::max(a, b)] = std::min(a, b);
+                }
             }
         });
 
-        if(emptyTileFound) {
-            std::cout << mca.maze() << std::endl;
-            return Result::NOK;
-        }
-        return Result::OK;
+        // The smaller root always wins, so a root is the first tile of its region in scan order.
+        std::vector<Region> regions;
+        std::unordered_map<std::size_t, std::size_t> regionOfRoot;
+        forInnerTiles(maze, [&](std::size_t idx) {
+            if(not isOpen(maze[idx])) {
+                return;
+            }
+            auto root = find(idx);
+            if(root == idx) {
+                regionOfRoot[root] = regions.size();
+                regions.push_back({maze.coordinates(idx), 0});
+            }
+            ++regions[regionOfRoot[root]].size;
+        });
+        return regions;
     }
 }
 }
@@ -1,10 +1,18 @@
 #pragma once
 
+#include <cstddef>
 #include <iosfwd>
+#include <vector>
+
+#include "Utils.hpp"
 
-struct Dimensions;
 struct Maze;
-class MazeCreator;
+struct Options;
+namespace rng {
+    class Xoshiro256StarStar;
+}
+template<typename Engine> class BasicMazeCreator;
+using MazeCreator = BasicMazeCreator<rng::Xoshiro256StarStar>;
 
 
 std::ostream& operator<<(std::ostream& os, const Maze& maze);
@@ -19,7 +27,15 @@ enum Result {
 
 
 namespace input {
-    Result commandLineArguments(int argc);
+    /// Parse `exec --serve [--socket path] [--queue q] [--max-tiles k] [--threads t]`,
+    ///       `exec x y [--seed n] [--batch count] [--tile-size s] [--threads t]
+    ///                       [--out file [--format text|binary]] [--solve a]
+    ///                       [--far-endpoints] [--min-distance d] [--stats report]
+    ///                       [--validate off|cheap|full] [--algorithm g]
+    ///                       [--best-of c [--metric m]]` or
+    ///       `exec x y --stream [--seed n] [--tile-size s] [--threads t] [--out file]
+    ///                       [--validate off|cheap|full] [--algorithm g]` into options.
+    Result commandLineArguments(int argc, const char* const* argv, Options& options);
 
     Result widthHeightMinimum(int x, int y);
 
@@ -30,7 +46,19 @@ namespace output {
     /// Check whether there are no 2x2 space tile clusters.
     Result noFreeClusters(const Maze& maze);
 
-    // Using the creator to utilize some functionalities that make traversal easier
-    Result fullyTraversable(MazeCreator& mc);
+    /// Check whether B and E are connected, at least `minDistance` steps apart.
+    Result endpointsApart(const Maze& maze, std::size_t minDistance);
+
+    /// Check whether every open tile can be reached from every other one, moving in all 8 directions.
+    Result fullyTraversable(const Maze& maze);
+
+    /// A separate area of open tiles, named by its first tile in scan order.
+    struct Region {
+        Coordinates first;
+        std::size_t size;
+    };
+
+    /// All areas of open tiles at once, from a single union-find pass; a good maze has one.
+    std::vector<Region> connectedRegions(const Maze& maze);
 }
 }
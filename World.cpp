@@ -0,0 +1,217 @@
+#include "World.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Algorithms.hpp"
+#include "RandomEngines.hpp"
+
+
+namespace world {
+    namespace {
+    /// Streams of the world seed; each chunk and each seam gets its own.
+    enum Stream : unsigned { CHUNK = 0, WEST_SEAM, NORTH_SEAM, FALLBACK_CHUNK };
+
+    std::uint64_t chunkKey(std::uint64_t cx, std::uint64_t cy) {
+        return (cx << 32) | cy;   // coordinates are 32 bits, so chunk indices are less
+    }
+    }
+
+    ChunkedWorld::ChunkedWorld(std::uint64_t seed, unsigned chunkSize, std::size_t cachedChunks)
+            : theSeed(seed)
+            , theChunkSize(std::max(MIN_CHUNK_SIZE, chunkSize))
+            , theCreator({theChunkSize + 2, theChunkSize + 2}, seed)
+            , theChunks(cachedChunks)
+            , theEdges(4 * cachedChunks) {
+    }
+
+    char ChunkedWorld::at(const Coordinates& tile) {
+        std::uint64_t period = theChunkSize + 1;
+        const auto& maze = chunk(tile.x / period, tile.y / period);
+        return maze[{static_cast<unsigned>(tile.x % period), static_cast<unsigned>(tile.y % period)}];
+    }
+
+    Maze ChunkedWorld::window(const Coordinates& topLeft, const Dimensions& dims) {
+        std::uint64_t period = theChunkSize + 1;
+        Maze result(dims);
+        for(unsigned y = 0; y < dims.y; ++y) {
+            std::uint64_t worldY = std::uint64_t(topLeft.y) + y;
+            auto localY = static_cast<unsigned>(worldY % period);
+            // Whole runs of a chunk's row at a time, rather than one lookup per tile.
+            for(unsigned x = 0; x < dims.x;) {
+                std::uint64_t worldX = std::uint64_t(topLeft.x) + x;
+                auto localX = static_cast<unsigned>(worldX % period);
+                auto run = std::min<std::uint64_t>(period - localX, dims.x - x);
+                const auto& maze = chunk(worldX / period, worldY / period);
+                std::memcpy(result.row(y) + x, maze.row(localY) + localX, run);
+                x += static_cast<unsigned>(run);
+            }
+        }
+        return result;
+    }
+
+    const Maze& ChunkedWorld::chunk(std::uint64_t cx, std::uint64_t cy) {
+        auto key = chunkKey(cx, cy);
+        if(auto cached = theChunks.find(key)) {
+            return *cached;
+        }
+
+        // The neighbours first, since drawing them takes the creator over.
+        if(cx > 0) {
+            theNeighbourEdges[WEST] = edges(cx - 1, cy)[EAST];
+        }
+        if(cy > 0) {
+            theNeighbourEdges[NORTH] = edges(cx, cy - 1)[SOUTH];
+        }
+        theNeighbourEdges[EAST] = edges(cx + 1, cy)[WEST];
+        theNeighbourEdges[SOUTH] = edges(cx, cy + 1)[NORTH];
+        const auto& own = edges(cx, cy);
+        if(theDrawn != key) {
+            draw(cx, cy);   // the creator holds a neighbour's drawing
+        }
+
+        // A seam's plan only depends on the paths first drawn on its two sides, so both agree on it.
+        std::optional<SeamPlan> west, north;
+        if(cx > 0) {
+            west = planSeam(theNeighbourEdges[WEST], own[WEST], mix(WEST_SEAM, cx, cy));
+        }
+        if(cy > 0) {
+            north = planSeam(theNeighbourEdges[NORTH], own[NORTH], mix(NORTH_SEAM, cx, cy));
+        }
+        auto east = planSeam(own[EAST], theNeighbourEdges[EAST], mix(WEST_SEAM, cx + 1, cy));
+        auto south = planSeam(own[SOUTH], theNeighbourEdges[SOUTH], mix(NORTH_SEAM, cx, cy + 1));
+        bool fallback =    (west && west->fallbackAfter) || (north && north->fallbackAfter)
+                        || east.fallbackBefore || south.fallbackBefore;
+        if(fallback) {
+            drawFallback(cx, cy);
+        } else if(theDrawn != key) {
+            draw(cx, cy);   // the creator holds a neighbour's drawing
+        }
+
+        unsigned last = theChunkSize + 1;   // the frame on the east and south
+        if(west) {
+            theCreator.openFrame({0, west->door + 1}, {1, west->door + 1});
+        }
+        if(north) {
+            theCreator.openFrame({north->door + 1, 0}, {north->door + 1, 1});
+        }
+        theCreator.openFrame({last, east.door + 1}, {last - 1, east.door + 1});
+        theCreator.openFrame({south.door + 1, last}, {south.door + 1, last - 1});
+        theCreator.finishChunk(not fallback);   // a perfect maze has no gaps but the doors' own
+        theDrawn.reset();
+        ++theChunksGenerated;
+        theFallbackChunks += fallback;
+
+        auto& maze = theChunks.insert(key, Dimensions{last + 1, last + 1});
+        maze = theCreator.result();
+        return maze;
+    }
+
+    const ChunkedWorld::Edges& ChunkedWorld::edges(std::uint64_t cx, std::uint64_t cy) {
+        auto key = chunkKey(cx, cy);
+        if(auto cached = theEdges.find(key)) {
+            return *cached;
+        }
+        draw(cx, cy);
+        auto& edges = theEdges.insert(key);
+        readEdges(edges);
+        return edges;
+    }
+
+    void ChunkedWorld::draw(std::uint64_t cx, std::uint64_t cy) {
+        theCreator.reset({theChunkSize + 2, theChunkSize + 2}, mix(CHUNK, cx, cy));
+        theCreator.drawOnly();
+        theDrawn = chunkKey(cx, cy);
+    }
+
+    /**
+     * A Kruskal maze on the cells at odd tiles. Every tile of its sides is a cell, a passage next to
+     * one, or (on the east and south of an even chunk size) next to either, so openFrame() can open
+     * a door anywhere on them without making a square, as long as it isn't at the seams' last tile.
+     * That is also why the doors don't close any gaps here.
+     */
+    void ChunkedWorld::drawFallback(std::uint64_t cx, std::uint64_t cy) {
+        theCreator.reset({theChunkSize + 2, theChunkSize + 2}, mix(FALLBACK_CHUNK, cx, cy));
+        theCreator.useAlgorithm(carve::Algorithm::KRUSKAL);
+        theCreator.drawOnly();
+        theCreator.useAlgorithm(carve::Algorithm::GROWTH);
+        theDrawn.reset();
+    }
+
+    void ChunkedWorld::readEdges(Edges& edges) const {
+        for(auto& side : edges) {
+            side.resize(theChunkSize);
+        }
+        for(unsigned p = 0; p < theChunkSize; ++p) {
+            edges[WEST][p] = theCreator.doorFit({1, p + 1});
+            edges[NORTH][p] = theCreator.doorFit({p + 1, 1});
+            edges[EAST][p] = theCreator.doorFit({theChunkSize, p + 1});
+            edges[SOUTH][p] = theCreator.doorFit({p + 1, theChunkSize});
+        }
+    }
+
+    /**
+     * The door from seamDoor(), or where none fits, the fallback for the chunk after the seam with
+     * the door on a path (or a tile that extends one) of the chunk before it. If that has neither,
+     * both chunks fall back and the door can go anywhere.
+     */
+    ChunkedWorld::SeamPlan ChunkedWorld::planSeam(const std::vector<DoorFit>& before,
+                                                  const std::vector<DoorFit>& after, std::uint64_t seamSeed) {
+        bool failed = theFailedSeams && seamSeed % theFailedSeams == 0;
+        if(auto door = failed ? std::nullopt : seamDoor(before, after, seamSeed)) {
+            return {*door, false, false};
+        }
+        auto& candidates = theCandidates;
+        candidates.clear();
+        for(unsigned p = 0; p + 1 < theChunkSize; ++p) {
+            if(before[p] == DoorFit::PATH) {
+                candidates.push_back(p);
+            }
+        }
+        if(candidates.empty()) {
+            for(unsigned p = 2; p + 2 < theChunkSize; ++p) {
+                if(before[p] == DoorFit::EXTENDED) {
+                    candidates.push_back(p);
+                }
+            }
+        }
+        rng::SplitMix64 rand(seamSeed);
+        if(candidates.empty()) {
+            return {static_cast<unsigned>(rand() % (theChunkSize - 1)), true, true};
+        }
+        return {candidates[rand() % candidates.size()], false, true};
+    }
+
+    /**
+     * Like createTiled()'s doors: one where both sides are paths if there is such a place,
+     * otherwise one that extends a side's paths by a tile. Extensions stay two tiles away from
+     * the ends of the seam, so the extensions of a chunk's four seams can't meet in a square, and
+     * no door is at the seam's last tile, where a fallback chunk couldn't take it (see drawFallback).
+     */
+    std::optional<unsigned> ChunkedWorld::seamDoor(const std::vector<DoorFit>& before,
+                                                   const std::vector<DoorFit>& after, std::uint64_t seamSeed) {
+        auto& candidates = theCandidates;
+        candidates.clear();
+        for(unsigned p = 0; p + 1 < theChunkSize; ++p) {
+            if(before[p] == DoorFit::PATH && after[p] == DoorFit::PATH) {
+                candidates.push_back(p);
+            }
+        }
+        if(candidates.empty()) {
+            for(unsigned p = 2; p + 2 < theChunkSize; ++p) {
+                if(   (before[p] == DoorFit::PATH && after[p] == DoorFit::EXTENDED)
+                   || (before[p] == DoorFit::EXTENDED && after[p] == DoorFit::PATH)) {
+                    candidates.push_back(p);
+                }
+            }
+        }
+        if(candidates.empty()) {
+            return std::nullopt;
+        }
+        return candidates[rng::SplitMix64(seamSeed)() % candidates.size()];
+    }
+
+    std::uint64_t ChunkedWorld::mix(unsigned kind, std::uint64_t cx, std::uint64_t cy) const {
+        return rng::streamSeed(rng::streamSeed(rng::streamSeed(theSeed, kind), cx), cy);
+    }
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Maze.hpp"
+#include "MazeCreator.hpp"
+#include "Utils.hpp"
+
+
+namespace world {
+    /// A fixed number of the most recently used values, the oldest one recycled for a new key.
+    template<typename Value>
+    class LruCache {
+    public:
+        explicit LruCache(std::size_t capacity) : theCapacity(std::max<std::size_t>(1, capacity)) {}
+
+        /// The value cached for `key`, now the most recently used one; nullptr if there is none.
+        Value* find(std::uint64_t key) {
+            auto found = theIndex.find(key);
+            if(found == theIndex.end()) {
+                return nullptr;
+            }
+            theEntries.splice(theEntries.begin(), theEntries, found->second);
+            return &found->second->second;
+        }
+
+        /**
+         * A slot for `key`, which must not be cached yet: a value made from `args`, or when the cache
+         * is full the one evicted, buffers and all.
+         */
+        template<typename... Args>
+        Value& insert(std::uint64_t key, Args&&... args) {
+            if(theEntries.size() < theCapacity) {
+                theEntries.emplace_front(std::piecewise_construct, std::forward_as_tuple(key),
+                                         std::forward_as_tuple(std::forward<Args>(args)...));
+            } else {
+                theIndex.erase(theEntries.back().first);
+                theEntries.splice(theEntries.begin(), theEntries, std::prev(theEntries.end()));
+                theEntries.front().first = key;
+            }
+            theIndex[key] = theEntries.begin();
+            return theEntries.front().second;
+        }
+
+        std::size_t size() const {
+            return theEntries.size();
+        }
+
+    private:
+        std::size_t theCapacity;
+        std::list<std::pair<std::uint64_t, Value>> theEntries;   // most recently used first
+        std::unordered_map<std::uint64_t, typename std::list<std::pair<std::uint64_t, Value>>::iterator> theIndex;
+    };
+
+
+    /**
+     * A maze as large as the coordinates go, generated in chunkSize x chunkSize chunks only when a
+     * tile of theirs is asked for, so memory and time follow the region looked at, not the world.
+     * Chunks are separated by one tile wide wall seams like the tiles of createTiled(); the world's
+     * top and left edges are walls, the other two never come. A chunk only depends on the world
+     * seed and its position: the door in a seam is chosen from the drawn paths next to it on both
+     * sides (which are drawn again when they aren't cached), so neighbours always agree on it.
+     * Where no door fits those paths, the chunk after the seam (and the one before it too, if it
+     * has nothing at all to offer) is drawn as a perfect maze instead, which takes a door anywhere;
+     * the doors are still placed by the paths first drawn, so its other neighbours agree as well.
+     * Not thread safe; every query may generate and evict chunks.
+     */
+    class ChunkedWorld {
+    public:
+        static constexpr unsigned MIN_CHUNK_SIZE = 8;
+
+        ChunkedWorld(std::uint64_t seed, unsigned chunkSize = 64, std::size_t cachedChunks = 256);
+
+        /// The tile at `tile`, generating its chunk if it isn't cached.
+        char at(const Coordinates& tile);
+
+        /// Copy of the `dims` tiles from `topLeft` on, generating the chunks it covers.
+        Maze window(const Coordinates& topLeft, const Dimensions& dims);
+
+        std::uint64_t seed() const {
+            return theSeed;
+        }
+
+        unsigned chunkSize() const {
+            return theChunkSize;
+        }
+
+        std::size_t cachedChunks() const {
+            return theChunks.size();
+        }
+
+        /// Chunks generated so far, counting the ones generated again after being evicted.
+        std::size_t chunksGenerated() const {
+            return theChunksGenerated;
+        }
+
+        /// Of chunksGenerated(), the ones drawn as perfect mazes because a seam of theirs had no door.
+        std::size_t fallbackChunks() const {
+            return theFallbackChunks;
+        }
+
+        /**
+         * For tests: treat one seam in `every` (picked by its seed) as if no door fitted it, so the
+         * fallback gets used. 0, the default, only falls back where no door fits.
+         */
+        void failDoorSearch(std::uint64_t every) {
+            theFailedSeams = every;
+        }
+
+    private:
+        using DoorFit = MazeCreator::DoorFit;
+        enum Side : unsigned { WEST = 0, NORTH, EAST, SOUTH, SIDE_COUNT };
+        /// How the drawn tiles along each side of a chunk can take a door.
+        using Edges = std::array<std::vector<DoorFit>, SIDE_COUNT>;
+
+        /// Where the door of a seam goes, and which of the chunks on its sides need the fallback.
+        struct SeamPlan {
+            unsigned door;
+            bool fallbackBefore;   ///< the chunk to the west or north
+            bool fallbackAfter;
+        };
+
+        /// The finished chunk with its frame, which holds the doors of its west and north seams.
+        const Maze& chunk(std::uint64_t cx, std::uint64_t cy);
+        const Edges& edges(std::uint64_t cx, std::uint64_t cy);
+        void draw(std::uint64_t cx, std::uint64_t cy);
+        void drawFallback(std::uint64_t cx, std::uint64_t cy);
+        void readEdges(Edges& edges) const;
+        SeamPlan planSeam(const std::vector<DoorFit>& before, const std::vector<DoorFit>& after, std::uint64_t seamSeed);
+        std::optional<unsigned> seamDoor(const std::vector<DoorFit>& before, const std::vector<DoorFit>& after,
+                                         std::uint64_t seamSeed);
+        std::uint64_t mix(unsigned kind, std::uint64_t cx, std::uint64_t cy) const;
+
+        std::uint64_t theSeed;
+        unsigned theChunkSize;
+        MazeCreator theCreator;
+        std::optional<std::uint64_t> theDrawn;   // the chunk the creator holds drawn, not yet finished
+        LruCache<Maze> theChunks;
+        LruCache<Edges> theEdges;   // of chunks drawn just to agree on the doors with their neighbours
+        Edges theNeighbourEdges;    // the sides facing the chunk being generated
+        std::vector<unsigned> theCandidates;
+        std::size_t theChunksGenerated = 0;
+        std::size_t theFallbackChunks = 0;
+        std::uint64_t theFailedSeams = 0;
+    };
+}
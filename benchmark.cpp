@@ -0,0 +1,200 @@
+/**
+ * Benchmarks of the generator, its phases, the other generation algorithms, the bitboard engine,
+ * a creator reused from maze to maze, the fixed size creators, the validators and the printer,
+ * on fixed seeds.
+ * Build it like the main program, with benchmark.cpp in place of main.cpp, and run:
+ *   <benchmark_name> [largest side]
+ * Sizes go from 20x20 up to 20000x20000, or up to the given side.
+ */
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <optional>
+#include <string>
+
+#include "Bitboard.hpp"
+#include "FixedMazeCreator.hpp"
+#include "MazeCreator.hpp"
+#include "Stats.hpp"
+#include "Utils.hpp"
+#include "Validators.hpp"
+
+
+namespace {
+    std::atomic<std::uint64_t> allocations{0};
+}
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if(void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+
+namespace {
+    const unsigned SIDES[] = {20, 200, 2000, 20000};
+    const std::uint64_t SEED = 20240601;
+    const std::size_t TILES_PER_SIZE = 20'000'000;   // small mazes are repeated up to about this many tiles
+
+    const char* const PHASE_NAMES[stats::PHASE_COUNT] = {
+        "  fillBorders", "  drawPaths", "  flip", "  closeGaps", "  dropEndpoints"
+    };
+
+    void printHeader() {
+        std::cout << std::left << std::setw(13) << "size" << std::setw(18) << "step" << std::right
+                  << std::setw(12) << "ms/run" << std::setw(14) << "Mtiles/s" << std::setw(14) << "allocs/run"
+                  << std::endl;
+    }
+
+    void printRow(unsigned side, const std::string& step, double milliseconds, std::size_t runs,
+                  std::uint64_t allocationCount, bool allocationsKnown = true) {
+        double perRun = milliseconds / runs;
+        double tiles = double(side) * side;
+        std::cout << std::left << std::setw(13) << (std::to_string(side) + "x" + std::to_string(side))
+                  << std::setw(18) << step << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(12) << perRun << std::setw(14) << std::setprecision(1)
+                  << (perRun > 0 ? tiles / perRun / 1000.0 : 0.0) << std::setw(14);
+        if(allocationsKnown) {
+            std::cout << allocationCount / runs;
+        } else {
+            std::cout << "-";
+        }
+        std::cout << std::endl;
+    }
+
+    /// Run `step` `runs` times and print how long it took and how much it allocated.
+    void measure(unsigned side, const std::string& step, std::size_t runs, const std::function<void()>& body) {
+        auto allocationsBefore = allocations.load();
+        double milliseconds = 0;
+        stats::timed(milliseconds, [&] {
+            for(std::size_t run = 0; run < runs; ++run) {
+                body();
+            }
+        });
+        printRow(side, step, milliseconds, runs, allocations.load() - allocationsBefore);
+    }
+
+    /// The sizes with a FixedMazeCreator of their own, against a warm dynamic creator.
+    template<unsigned SIDE>
+    void benchmarkHotSize() {
+        const std::size_t runs = TILES_PER_SIZE / (SIDE * SIDE);
+        MazeCreator reused({SIDE, SIDE}, SEED);
+        std::uint64_t seed = SEED;
+        measure(SIDE, "regenerate", runs, [&] {
+            reused.regenerate(seed++);
+        });
+        FixedMazeCreator<SIDE, SIDE> fixed(SEED);
+        seed = SEED;
+        measure(SIDE, "fixed size", runs, [&] {
+            fixed.regenerate(seed++);
+        });
+    }
+
+    int benchmark(unsigned side) {
+        std::size_t tiles = std::size_t(side) * side;
+        std::size_t runs = std::max<std::size_t>(1, TILES_PER_SIZE / tiles);
+
+        // End to end; the phases come from the creator's own stats.
+        stats::Generation phases;
+        auto allocationsBefore = allocations.load();
+        double milliseconds = 0;
+        std::optional<Maze> maze;
+        for(std::size_t run = 0; run < runs; ++run) {
+            MazeCreator mc({side, side}, SEED + run);
+            stats::timed(milliseconds, [&] { mc.create(); });
+            for(unsigned phase = 0; phase < stats::PHASE_COUNT; ++phase) {
+                phases.milliseconds[phase] += mc.stats().milliseconds[phase];
+            }
+            maze = mc.takeResult();
+        }
+        printRow(side, "create", milliseconds, runs, allocations.load() - allocationsBefore);
+        if(stats::ENABLED) {
+            for(unsigned phase = 0; phase < stats::PHASE_COUNT; ++phase) {
+                printRow(side, PHASE_NAMES[phase], phases.milliseconds[phase], runs, 0, false);
+            }
+        }
+
+        for(const auto& [algorithm, name] : carve::NAMES) {
+            if(algorithm == carve::Algorithm::GROWTH) {
+                continue;   // that's create
+            }
+            std::uint64_t seed = SEED;
+            measure(side, std::string(name), runs, [&, algorithm = algorithm] {
+                MazeCreator mc({side, side}, seed++);
+                mc.useAlgorithm(algorithm);
+                mc.create();
+            });
+        }
+
+        std::uint64_t bitboardSeed = SEED;
+        measure(side, "bitboard create", runs, [&] {
+            BitboardCreator creator({side, side}, bitboardSeed++);
+            creator.create();
+        });
+
+        MazeCreator reused({side, side}, SEED);
+        std::uint64_t seed = SEED;
+        measure(side, "regenerate", runs, [&] {
+            reused.regenerate(seed++);
+        });
+
+        bool valid = true;
+        measure(side, "noFreeClusters", runs, [&] {
+            valid &= validate::output::noFreeClusters(*maze) == validate::Result::OK;
+        });
+        measure(side, "fullyTraversable", runs, [&] {
+            valid &= validate::output::fullyTraversable(*maze) == validate::Result::OK;
+        });
+        std::ofstream sink("/dev/null");
+        measure(side, "operator<<", runs, [&] {
+            sink << *maze;
+        });
+        if(not valid) {
+            utils::errorMsg("Invalid maze of ") << side << "x" << side << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+}
+
+
+int main(int argc, char** argv) {
+    unsigned largest = 20000;
+    if(argc > 1) {
+        auto value = utils::convertToUnsigned(argv[1]);
+        if(not value || *value < 20) {
+            utils::errorMsg("The largest side needs to be a number, at least 20!");
+            return 1;
+        }
+        largest = static_cast<unsigned>(*value);
+    }
+
+    std::cout << "Seeds from " << SEED << (stats::ENABLED ? "" : ", phases not recorded (MAZY_NO_STATS)") << std::endl;
+    printHeader();
+    benchmarkHotSize<15>();
+    benchmarkHotSize<21>();
+    benchmarkHotSize<31>();
+    for(auto side : SIDES) {
+        if(side <= largest && benchmark(side) != 0) {
+            return 1;
+        }
+    }
+    std::cout << "Peak RSS: " << stats::peakMemoryBytes() / (1024 * 1024) << " MiB" << std::endl;
+    return 0;
+}
@@ -1,54 +1,284 @@
+#include <fstream>
 #include <iostream>
+#include <string>
 
+#include "Algorithms.hpp"
+#include "Analytics.hpp"
+#include "Batch.hpp"
+#include "Kernels.hpp"
 #include "MazeCreator.hpp"
+#include "MazeIO.hpp"
+#include "Options.hpp"
+#include "Server.hpp"
+#include "Solver.hpp"
+#include "Stats.hpp"
+#include "StreamingCreator.hpp"
+#include "ThreadPool.hpp"
 #include "Utils.hpp"
 #include "Validators.hpp"
 
-#include "tests.hpp"
 
 
+validate::Result writeOutput(const Options& options, const Maze& maze, std::uint64_t seed,
+                             const std::string& path) {
+    return options.binary ? io::writeBinary(maze, seed, path) : io::writeText(maze, path);
+}
+
+/// The statistics of every maze of the run, as one JSON object.
+validate::Result writeStats(const Options& options, const std::vector<std::uint64_t>& seeds,
+                            const std::vector<stats::Generation>& generations) {
+    std::ofstream report(options.statsPath);
+    report << "{\"width\": " << options.x << ", \"height\": " << options.y
+           << ", \"tileSize\": " << options.tileSize << ", \"algorithm\": \"" << options.algorithm
+           << "\", \"statsEnabled\": " << std::boolalpha
+           << stats::ENABLED << ",\n \"mazes\": [";
+    for(std::size_t i = 0; i < generations.size(); ++i) {
+        report << (i ? ",\n   " : "\n   ") << "{\"seed\": " << seeds[i] << ", \"generation\": ";
+        stats::writeJson(report, generations[i]);
+        report << "}";
+    }
+    report << "],\n \"peakMemoryBytes\": " << stats::peakMemoryBytes() << "}" << std::endl;
+    if(not report) {
+        utils::errorMsg("Couldn't write the statistics to " + options.statsPath);
+        return validate::Result::NOK;
+    }
+    return validate::Result::OK;
+}
+
+EndpointPlacement endpointPlacement(const Options& options) {
+    return {options.farEndpoints, options.minDistance};
+}
 
-int xFromArgs(char** argv) {
-    return utils::convertToInt(const_cast<const char*>(argv[1]));
+/// Report the solution and draw it into the maze.
+validate::Result drawSolution(const Options& options, const solve::Solution& solution, Maze& maze) {
+    if(not solution.solved) {
+        utils::errorMsg("No path from B to E!") << std::endl << maze;
+        return validate::Result::NOK;
+    }
+    std::cout << "Shortest path: " << solution.moves.size() << " steps, " << solution.expanded
+              << " tiles expanded (" << options.solver << ")" << std::endl;
+    solve::overlay(maze, solution);
+    return validate::Result::OK;
+}
+
+/// What's wrong with the maze, as far as the chosen validation level looks; empty if nothing.
+std::string problemWith(const Options& options, const Maze& maze) {
+    if(options.validation == Validation::OFF) {
+        return "";
+    }
+    if(validate::output::noFreeClusters(maze) == validate::Result::NOK) {
+        return "Large free cluster in map!";
+    }
+    if(options.validation == Validation::CHEAP) {
+        return "";
+    }
+    if(validate::output::fullyTraversable(maze) == validate::Result::NOK) {
+        return "Maze not fully traversible!";
+    }
+    if(options.minDistance && validate::output::endpointsApart(maze, options.minDistance) == validate::Result::NOK) {
+        return "B and E are less than " + std::to_string(options.minDistance) + " steps apart!";
+    }
+    return "";
 }
 
-int yFromArgs(char** argv) {
-    return utils::convertToInt(const_cast<const char*>(argv[2]));
+int runBatch(const Options& options, const Dimensions& dims, std::uint64_t seedBase) {
+    std::cout << std::endl << "Generating " << options.batch << " mazes of " << options.x << "x"
+              << options.y << " (seed base " << seedBase << ")" << std::endl;
+
+    ThreadPool pool(options.threads);
+    std::vector<stats::Generation> generations;
+    auto mazes = batch::generate(options.batch, dims, seedBase, pool, endpointPlacement(options),
+                                 *carve::algorithmFromName(options.algorithm), &generations);
+    if(not options.statsPath.empty()) {
+        std::vector<std::uint64_t> seeds;
+        for(std::size_t i = 0; i < mazes.size(); ++i) {
+            seeds.push_back(batch::mazeSeed(seedBase, i));
+        }
+        if(writeStats(options, seeds, generations) == validate::Result::NOK) {
+            return 1;
+        }
+    }
+
+    std::vector<std::string> problems(mazes.size());
+    std::vector<solve::Solution> solutions(mazes.size());
+    pool.parallelFor(mazes.size(), [&](std::size_t index, unsigned) {
+        problems[index] = problemWith(options, mazes[index]);
+        if(not options.solver.empty()) {
+            solutions[index] = solve::shortestPath(mazes[index], *solve::algorithmFromName(options.solver));
+        }
+    });
+    for(std::size_t i = 0; i < mazes.size(); ++i) {
+        if(not problems[i].empty()) {
+            utils::errorMsg(problems[i]) << std::endl << mazes[i];
+            return 1;
+        }
+        std::cout << std::endl << "Maze " << i << " (seed " << batch::mazeSeed(seedBase, i) << ")"
+                  << std::endl;
+        if(not options.solver.empty() && drawSolution(options, solutions[i], mazes[i]) == validate::Result::NOK) {
+            return 1;
+        }
+        if(options.outputPath.empty()) {
+            std::cout << mazes[i];
+        } else if(writeOutput(options, mazes[i], batch::mazeSeed(seedBase, i),
+                              options.outputPath + "." + std::to_string(i)) == validate::Result::NOK) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/// Generate the candidates, then check, solve and output the hardest one like a single maze.
+int runBestOf(const Options& options, const Dimensions& dims, std::uint64_t seedBase) {
+    auto metric = *analytics::metricFromName(options.metric);
+    std::cout << std::endl << "Generating the best of " << options.bestOf << " mazes of " << options.x << "x"
+              << options.y << " by " << analytics::name(metric) << " (seed base " << seedBase << ")" << std::endl;
+
+    ThreadPool pool(options.threads);
+    stats::Generation generation;
+    auto best = batch::bestOf(options.bestOf, dims, seedBase, pool, endpointPlacement(options),
+                              *carve::algorithmFromName(options.algorithm), metric, &generation);
+    auto seed = batch::mazeSeed(seedBase, best.index);
+    if(   not options.statsPath.empty()
+       && writeStats(options, {seed}, {generation}) == validate::Result::NOK) {
+        return 1;
+    }
+
+    auto problem = problemWith(options, best.maze);
+    if(not problem.empty()) {
+        utils::errorMsg(problem) << std::endl << best.maze;
+        return 1;
+    }
+    std::cout << "Kept candidate " << best.index << " (seed " << seed << "): ";
+    analytics::writeJson(std::cout, best.analysis);
+    std::cout << std::endl;
+    if(not options.solver.empty()) {
+        auto solution = solve::shortestPath(best.maze, *solve::algorithmFromName(options.solver));
+        if(drawSolution(options, solution, best.maze) == validate::Result::NOK) {
+            return 1;
+        }
+    }
+    if(not options.outputPath.empty()) {
+        return writeOutput(options, best.maze, seed, options.outputPath) == validate::Result::OK ? 0 : 1;
+    }
+    std::cout << best.maze;
+    return 0;
+}
+
+/**
+ * Generate the maze band by band straight into the output. Only the cluster scan can be done on
+ * the rows going by; a streamed maze is connected by the way its bands are stitched.
+ */
+int runStreamed(const Options& options, const Dimensions& dims, std::uint64_t seed) {
+    const unsigned DEFAULT_TILE_SIZE = 64;
+    std::cout << std::endl << "Streaming " << options.x << "x" << options.y << " maze (seed " << seed << ")"
+              << std::endl;
+
+    std::ofstream file;
+    if(not options.outputPath.empty()) {
+        file.open(options.outputPath, std::ios::binary);
+    }
+    std::ostream& out = options.outputPath.empty() ? std::cout : file;
+    ThreadPool pool(options.threads);
+    StreamingCreator creator(dims, options.tileSize ? options.tileSize : DEFAULT_TILE_SIZE, seed);
+    creator.useAlgorithm(*carve::algorithmFromName(options.algorithm));
+    std::size_t stride = std::size_t(dims.x) + 1;
+    std::string lastRow;   // of the rows handed on before, the window may have moved on since
+    bool clustered = false;
+    bool stitched = creator.create(pool, [&](const char* rows, std::size_t size) {
+        if(options.validation != Validation::OFF) {
+            const char* above = lastRow.empty() ? nullptr : lastRow.data();
+            for(const char* row = rows; row < rows + size; row += stride) {
+                clustered |= above && kernels::hasFreeCluster(above + 1, row + 1, dims.x - 2);
+                above = row;
+            }
+            lastRow.assign(rows + size - stride, stride);
+        }
+        out.write(rows, static_cast<std::streamsize>(size));
+    });
+    out.flush();
+    if(not stitched) {
+        utils::errorMsg("Couldn't stitch the bands of the maze; it was cut short!");
+        return 1;
+    }
+    if(clustered) {
+        utils::errorMsg("Large free cluster in map!");
+        return 1;
+    }
+    if(not out) {
+        utils::errorMsg("Couldn't write the maze" + (options.outputPath.empty() ? "" : " to " + options.outputPath));
+        return 1;
+    }
+    return 0;
 }
 
 int main(int argc, char** argv) {
-    if(validate::input::commandLineArguments(argc) == validate::Result::NOK) {
+    Options options;
+    if(validate::input::commandLineArguments(argc, argv, options) == validate::Result::NOK) {
         return 1;
     }
 
-    int x = xFromArgs(argv);
-    int y = yFromArgs(argv);
-    if(validate::input::widthHeightMinimum(x, y) == validate::Result::NOK) {
+    if(options.serve) {
+        std::ios::sync_with_stdio(false);   // lets the server see requests that are already waiting
+        ThreadPool pool(options.threads);
+        server::Server server(pool, options.queueLength, options.maxTiles);
+        if(not options.socketPath.empty()) {
+            return server::listen(options.socketPath, server) == validate::Result::OK ? 0 : 1;
+        }
+        server.serve(std::cin, std::cout);
+        return 0;
+    }
+
+    if(validate::input::widthHeightMinimum(options.x, options.y) == validate::Result::NOK) {
         return 1;
     }
 
     // since input has been validated to be larger than 0, this cast is safe
-    Dimensions dims{static_cast<unsigned int>(x), static_cast<unsigned int>(y)};
+    Dimensions dims{static_cast<unsigned int>(options.x), static_cast<unsigned int>(options.y)};
 
-    if(validate::tests() == validate::Result::NOK)
-    {
-        return -1;
+    auto seed = options.seed.value_or(RandomCoordinateGenerator::entropySeed());
+    if(options.stream) {
+        return runStreamed(options, dims, seed);
+    }
+    if(options.batch > 1) {
+        return runBatch(options, dims, seed);
+    }
+    if(options.bestOf > 1) {
+        return runBestOf(options, dims, seed);
     }
 
-    std::cout << std::endl << "Generating " << x << "x" << y << " maze" << std::endl;
-
-    MazeCreator mc(std::move(dims));
-    mc.create();
+    std::cout << std::endl << "Generating " << options.x << "x" << options.y << " maze (seed "
+              << seed << ")" << std::endl;
 
-    if(validate::output::noFreeClusters(mc.result()) == validate::Result::NOK) {
-        utils::errorMsg("Large free cluster in map!") << std::endl << mc.result();
+    MazeCreator mc(std::move(dims), seed);
+    mc.placeEndpoints(endpointPlacement(options));
+    mc.useAlgorithm(*carve::algorithmFromName(options.algorithm));
+    if(options.tileSize) {
+        ThreadPool pool(options.threads);
+        mc.createTiled(pool, options.tileSize);
+    } else {
+        mc.create();
+    }
+    if(   not options.statsPath.empty()
+       && writeStats(options, {seed}, {mc.stats()}) == validate::Result::NOK) {
         return 1;
     }
-    if(validate::output::fullyTraversable(mc) == validate::Result::NOK) {
-        utils::errorMsg("Maze not fully traversible!") << std::endl << mc.result();
+
+    auto problem = problemWith(options, mc.result());
+    if(not problem.empty()) {
+        utils::errorMsg(problem) << std::endl << mc.result();
         return 1;
     }
-    std::cout << mc.result();
+    auto maze = mc.takeResult();
+    if(not options.solver.empty()) {
+        auto solution = solve::shortestPath(maze, *solve::algorithmFromName(options.solver));
+        if(drawSolution(options, solution, maze) == validate::Result::NOK) {
+            return 1;
+        }
+    }
+    if(not options.outputPath.empty()) {
+        return writeOutput(options, maze, seed, options.outputPath) == validate::Result::OK ? 0 : 1;
+    }
+    std::cout << maze;
 
     return 0;
 }
@@ -0,0 +1,6 @@
+#include "tests.hpp"
+
+
+int main() {
+    return validate::tests() == validate::Result::OK ? 0 : 1;
+}
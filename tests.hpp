@@ -1,15 +1,38 @@
 #pragma once
 
+#include "Analytics.hpp"
+#include "Batch.hpp"
+#include "Bitboard.hpp"
+#include "FixedMazeCreator.hpp"
+#include "Kernels.hpp"
+#include "MazeCreator.hpp"
+#include "MazeIO.hpp"
+#include "Options.hpp"
+#include "RandomEngines.hpp"
 #include "RandomGenerator.hpp"
+#include "Server.hpp"
+#include "Solver.hpp"
+#include "Stats.hpp"
+#include "StreamingCreator.hpp"
+#include "ThreadPool.hpp"
 #include "Validators.hpp"
+#include "World.hpp"
 
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
 #include <map>
 #include <numeric>
+#include <random>
 #include <set>
+#include <sstream>
+#include <string>
 #include <thread>
+#include <vector>
 
 
 namespace validate {
@@ -44,8 +67,349 @@ Result randDistribution() {
         return Result::NOK;
     }
 
+    // Counts past 32 bits are picked from whole words, smaller ones exactly like pickRandomFrom().
+    RandomCoordinateGenerator small(bb, 5), index(bb, 5);
+    const std::uint64_t huge = (std::uint64_t(1) << 40) + 3;
+    bool above32 = false;
+    for(unsigned int i = 0; i < 1000; ++i) {
+        if(small.pickRandomFrom(1000) != index.pickRandomIndex(1000)) {
+            utils::errorMsg("pickRandomIndex differs from pickRandomFrom for a small count!");
+            return Result::NOK;
+        }
+        auto pick = rnd.pickRandomIndex(huge);
+        if(pick >= huge) {
+            utils::errorMsg("pickRandomIndex out of range: ") << pick << std::endl;
+            return Result::NOK;
+        }
+        above32 |= pick > std::numeric_limits<std::uint32_t>::max();
+    }
+    if(not above32) {
+        utils::errorMsg("pickRandomIndex never picks past 32 bits!");
+        return Result::NOK;
+    }
+
+    return Result::OK;
+
+}
+
+Result batchGeneration() {
+    std::cout << "Testing batch generation...";
+    const std::uint64_t SEED_BASE = 1234;
+    ThreadPool single(1);
+    ThreadPool several(3);
+    auto serial = batch::generate(24, {23,19}, SEED_BASE, single, {}, carve::Algorithm::GROWTH);
+    auto parallel = batch::generate(24, {23,19}, SEED_BASE, several, {}, carve::Algorithm::GROWTH);
+    for(std::size_t i = 0; i < serial.size(); ++i) {
+        MazeCreator mc({23,19}, batch::mazeSeed(SEED_BASE, i));
+        mc.create();
+        if(serial[i].array != parallel[i].array || serial[i].array != mc.result().array) {
+            utils::errorMsg("Batch maze depends on scheduling: ") << i << std::endl;
+            return Result::NOK;
+        }
+        if(output::noFreeClusters(parallel[i]) == Result::NOK) {
+            utils::errorMsg("Large free cluster in map!") << std::endl << parallel[i];
+            return Result::NOK;
+        }
+    }
+
+    // Two callers of one pool take turns instead of overwriting each other's loop.
+    std::vector<std::size_t> counted(2, 0);
+    std::vector<std::thread> callers;
+    for(std::size_t caller = 0; caller < counted.size(); ++caller) {
+        callers.emplace_back([&, caller] {
+            for(unsigned round = 0; round < 200; ++round) {
+                std::atomic<std::size_t> calls{0};
+                several.parallelFor(50, [&](std::size_t, unsigned) { ++calls; });
+                counted[caller] += calls;
+            }
+        });
+    }
+    for(auto& caller : callers) {
+        caller.join();
+    }
+    if(counted[0] != 200 * 50 || counted[1] != 200 * 50) {
+        utils::errorMsg("Concurrent loops on one pool lost calls: ") << counted[0] << " " << counted[1] << std::endl;
+        return Result::NOK;
+    }
+    std::cout << "Done!" << std::endl;
     return Result::OK;
+}
 
+Result bestOfGeneration() {
+    std::cout << "Testing best-of generation...";
+    const std::uint64_t SEED_BASE = 77;
+    ThreadPool single(1);
+    ThreadPool several(3);
+    auto candidates = batch::generate(20, {31,17}, SEED_BASE, single, {}, carve::Algorithm::GROWTH);
+    for(auto metric : {analytics::Metric::DEAD_ENDS, analytics::Metric::LOOPS, analytics::Metric::PATH_LENGTH,
+                       analytics::Metric::BRANCHING_FACTOR}) {
+        std::size_t expected = 0;
+        double highest = -1;
+        for(std::size_t i = 0; i < candidates.size(); ++i) {
+            auto score = analytics::score(analytics::analyze(candidates[i]), metric);
+            if(score > highest) {
+                highest = score;
+                expected = i;
+            }
+        }
+        auto serial = batch::bestOf(20, {31,17}, SEED_BASE, single, {}, carve::Algorithm::GROWTH, metric);
+        auto parallel = batch::bestOf(20, {31,17}, SEED_BASE, several, {}, carve::Algorithm::GROWTH, metric);
+        if(   serial.index != expected || parallel.index != expected
+           || parallel.maze.array != candidates[expected].array
+           || analytics::score(parallel.analysis, metric) != highest) {
+            utils::errorMsg("Best of 20 by ") << analytics::name(metric) << " kept " << serial.index << " and "
+                << parallel.index << " instead of " << expected << std::endl;
+            return Result::NOK;
+        }
+    }
+    std::cout << "Done!" << std::endl;
+    return Result::OK;
+}
+
+Result tiledGeneration() {
+    std::cout << "Testing tiled generation...";
+    ThreadPool single(1);
+    ThreadPool several(3);
+    for(unsigned int i = 0; i < 20; ++i) {
+        Dimensions dims{40 + i * 7, 30 + i * 3};
+        MazeCreator serial(Dimensions(dims), i);
+        MazeCreator parallel(Dimensions(dims), i);
+        serial.createTiled(single, 4 + i);
+        parallel.createTiled(several, 4 + i);
+        if(serial.result().array != parallel.result().array) {
+            utils::errorMsg("Tiled maze depends on scheduling: ") << dims.x << "-" << dims.y << std::endl;
+            return Result::NOK;
+        }
+        if(output::noFreeClusters(parallel.result()) == Result::NOK) {
+            utils::errorMsg("Large free cluster in map!") << std::endl << parallel.result();
+            return Result::NOK;
+        }
+        if(output::fullyTraversable(parallel.result()) == Result::NOK) {
+            utils::errorMsg("Maze not fully traversible!") << std::endl << parallel.result();
+            return Result::NOK;
+        }
+    }
+    MazeCreator whole({50, 50}, 1);
+    whole.createTiled(several, std::numeric_limits<unsigned>::max());   // one tile, not a division by 0
+    if(output::fullyTraversable(whole.result()) == Result::NOK) {
+        utils::errorMsg("Maze of the largest tile size not fully traversible!") << std::endl << whole.result();
+        return Result::NOK;
+    }
+    std::cout << "Done!" << std::endl;
+    return Result::OK;
+}
+
+Result streamedGeneration() {
+    std::cout << "Testing streamed generation...";
+    ThreadPool single(1);
+    ThreadPool several(3);
+    for(unsigned int i = 0; i < 12; ++i) {
+        Dimensions dims{30 + i * 11, 200 + i * 37};
+        std::string serial, parallel;
+        StreamingCreator first(dims, 4 + i, i);
+        StreamingCreator second(dims, 4 + i, i);
+        if(i % 3 == 2) {   // every band has to fall back to a perfect maze
+            first.failStitching(~0u);
+            second.failStitching(~0u);
+        }
+        bool stitched = first.create(single, [&](const char* rows, std::size_t size) { serial.append(rows, size); });
+        stitched &= second.create(several, [&](const char* rows, std::size_t size) { parallel.append(rows, size); });
+        if(not stitched || (i % 3 == 2 && first.fallbackBands() == 0)) {
+            utils::errorMsg("Streamed maze wasn't stitched: ") << dims.x << "-" << dims.y << std::endl;
+            return Result::NOK;
+        }
+        if(serial != parallel) {
+            utils::errorMsg("Streamed maze depends on scheduling: ") << dims.x << "-" << dims.y << std::endl;
+            return Result::NOK;
+        }
+        if(first.windowHeight() > 2 * (2 * (4 + i) + 1) + 3) {
+            utils::errorMsg("Streaming held ") << first.windowHeight() << " rows!" << std::endl;
+            return Result::NOK;
+        }
+
+        Maze maze(dims);
+        if(serial.size() != maze.array.size()) {
+            utils::errorMsg("Streamed maze has the wrong size: ") << dims.x << "-" << dims.y << std::endl;
+            return Result::NOK;
+        }
+        maze.array.assign(serial.begin(), serial.end());
+        if(   std::count(serial.begin(), serial.end(), BEGIN) != 1 || std::count(serial.begin(), serial.end(), END) != 1
+           || output::noFreeClusters(maze) == Result::NOK || output::fullyTraversable(maze) == Result::NOK) {
+            utils::errorMsg("Invalid streamed maze:") << std::endl << maze;
+            return Result::NOK;
+        }
+    }
+    std::cout << "Done!" << std::endl;
+    return Result::OK;
+}
+
+Result bitboardGeneration() {
+    std::cout << "Testing bitboard generation...";
+    for(unsigned int i = 0; i < 30; ++i) {
+        Dimensions dims{4 + i * 9, 4 + i * 5};
+        MazeCreator mc(Dimensions(dims), i);
+        BitboardCreator bc(dims, i);
+        mc.create();
+        bc.create();
+        if(bc.result().array != mc.result().array) {
+            utils::errorMsg("Bitboard maze differs for ") << dims.x << "-" << dims.y << std::endl << bc.result();
+            return Result::NOK;
+        }
+        if(bc.board().hasFreeCluster()) {
+            utils::errorMsg("Bitboard finds a cluster in ") << dims.x << "-" << dims.y << std::endl;
+            return Result::NOK;
+        }
+    }
+
+    Bitboard board({130, 6});
+    for(unsigned x : {63u, 64u}) {
+        for(unsigned y : {2u, 3u}) {
+            board.set({x, y});
+        }
+    }
+    if(not board.hasFreeCluster()) {
+        utils::errorMsg("Bitboard misses a cluster across words!");
+        return Result::NOK;
+    }
+    for(unsigned bit : {0u, 1u, 31u, 32u, 63u}) {
+        if(bitboard::lowestBit((std::uint64_t(1) << bit) | (std::uint64_t(1) << 63)) != bit) {
+            utils::errorMsg("Wrong lowest bit for ") << bit << std::endl;
+            return Result::NOK;
+        }
+    }
+    std::cout << "Done!" << std::endl;
+    return Result::OK;
+}
+
+template<unsigned W, unsigned H>
+Result fixedSize() {
+    for(std::uint64_t seed = 0; seed < 50; ++seed) {
+        MazeCreator mc({W, H}, seed);
+        FixedMazeCreator<W, H> fixed(seed);
+        mc.create();
+        fixed.create();
+        if(fixed.text() != mc.result().text() || fixed.result().array != mc.result().array) {
+            utils::errorMsg("Fixed size maze differs for ") << W << "-" << H << " seed " << seed << std::endl;
+            return Result::NOK;
+        }
+    }
+    return Result::OK;
+}
+
+Result fixedSizeGeneration() {
+    std::cout << "Testing fixed size generation...";
+    std::string text;
+    if(   fixedSize<15, 15>() == Result::NOK || fixedSize<21, 21>() == Result::NOK
+       || fixedSize<31, 31>() == Result::NOK || fixedSize<4, 9>() == Result::NOK
+       || fixedSize<40, 7>() == Result::NOK) {
+        return Result::NOK;
+    }
+    MazeCreator mc({21, 21}, 77);
+    mc.create();
+    if(   not fixed::appendText({21, 21}, 77, text) || text != mc.result().text()
+       || fixed::appendText({21, 22}, 77, text) || fixed::isHotSize({22, 21})) {
+        utils::errorMsg("Hot sizes aren't picked up right!");
+        return Result::NOK;
+    }
+    std::cout << "Done!" << std::endl;
+    return Result::OK;
+}
+
+Result carveAlgorithms() {
+    std::cout << "Testing generation algorithms...";
+    ThreadPool pool(2);
+    for(const auto& [algorithm, name] : carve::NAMES) {
+        if(carve::algorithmFromName(name) != algorithm || carve::name(algorithm) != name) {
+            utils::errorMsg("Algorithm names don't round trip: ") << name << std::endl;
+            return Result::NOK;
+        }
+        for(unsigned int i = 0; i < 16; ++i) {
+            Dimensions dims{4 + i * 7, 4 + i * 4};
+            MazeCreator mc(Dimensions(dims), i);
+            MazeCreator again(Dimensions(dims), i);
+            MazeCreator tiled(Dimensions(dims), i);
+            for(auto* creator : {&mc, &again, &tiled}) {
+                creator->useAlgorithm(algorithm);
+            }
+            mc.create();
+            again.create();
+            tiled.createTiled(pool, 5 + i);
+            for(const auto* maze : {&mc.result(), &tiled.result()}) {
+                if(   output::noFreeClusters(*maze) == Result::NOK || output::fullyTraversable(*maze) == Result::NOK
+                   || output::endpointsApart(*maze, 0) == Result::NOK) {
+                    utils::errorMsg("Invalid maze from ") << name << std::endl << *maze;
+                    return Result::NOK;
+                }
+            }
+            if(mc.result().array != again.result().array) {
+                utils::errorMsg("Same seed, different maze from ") << name << std::endl;
+                return Result::NOK;
+            }
+        }
+    }
+    std::cout << "Done!" << std::endl;
+    return Result::OK;
+}
+
+Result binaryFormat() {
+    std::cout << "Testing binary format...";
+    auto path = (std::filesystem::temp_directory_path() / "mazy_binary_test.maze").string();
+    for(Dimensions dims : {Dimensions{3,4}, Dimensions{20,20}, Dimensions{67,13}}) {
+        MazeCreator mc(Dimensions(dims), 99);
+        mc.create();
+        if(io::writeBinary(mc.result(), mc.seed(), path) == Result::NOK) {
+            return Result::NOK;
+        }
+        io::MappedMaze mapped;
+        if(mapped.open(path) == Result::NOK) {
+            return Result::NOK;
+        }
+        bool tilesMatch = true;
+        for(unsigned int y = 0; y < dims.y; ++y) {
+            for(unsigned int x = 0; x < dims.x; ++x) {
+                tilesMatch &= mapped[{x, y}] == mc.result()[{x, y}];
+            }
+        }
+        if(   mapped.seed() != 99 || mapped.dims().x != dims.x || mapped.dims().y != dims.y
+           || not tilesMatch || mapped.toMaze().array != mc.result().array) {
+            utils::errorMsg("Binary maze doesn't match the original!") << std::endl << mc.result();
+            return Result::NOK;
+        }
+    }
+    std::filesystem::remove(path);
+    std::cout << "Done!" << std::endl;
+    return Result::OK;
+}
+
+template<typename Engine>
+Result rngEngine(const char* name) {
+    std::cout << "Testing " << name << " engine...";
+    BasicRandomCoordinateGenerator<Engine> rnd({ {1,1}, {100,100} }, 7);
+
+    const unsigned int SAMPLE_SIZE = 80000;
+    unsigned int heads = 0;
+    std::vector<unsigned int> picks(8, 0);
+    for(unsigned int i = 0; i < SAMPLE_SIZE; ++i) {
+        heads += rnd.coinFlip();
+        ++picks[rnd.pickRandomFrom(8)];
+    }
+    auto expectedPicks = SAMPLE_SIZE / 8;
+    bool picksUniform = std::all_of(picks.begin(), picks.end(), [&](unsigned int count) {
+        return count > expectedPicks * 0.95 && count < expectedPicks * 1.05;
+    });
+    if(heads < SAMPLE_SIZE * 0.48 || heads > SAMPLE_SIZE * 0.52 || not picksUniform) {
+        utils::errorMsg("Engine doesn't seem to uniformly distribute: ") << name << std::endl;
+        return Result::NOK;
+    }
+
+    BasicMazeCreator<Engine> mc({20,20}, 7);
+    mc.create();
+    if(output::noFreeClusters(mc.result()) == Result::NOK) {
+        utils::errorMsg("Large free cluster in map!") << std::endl << mc.result();
+        return Result::NOK;
+    }
+    std::cout << "Done!" << std::endl;
+    return Result::OK;
 }
 
 Result subsequentRandomization()     {
@@ -93,17 +457,254 @@ Result subsequentRandomization()     {
 
 Result commandLineArgs() {
     std::cout << "Testing cmd line args (ignore subsequent error msgs)\n";
-    if(not input::commandLineArguments(1) && not input::commandLineArguments(2) &
-       not input::commandLineArguments(4) && not input::commandLineArguments(5)) {
-        utils::errorMsg("cmd validator error for error cases!");
+    auto parse = [](std::vector<const char*> args) {
+        Options options;
+        args.insert(args.begin(), "exec");
+        return input::commandLineArguments(static_cast<int>(args.size()), args.data(), options);
+    };
+    const std::vector<std::vector<const char*>> rejected = {
+        {}, {"10"}, {"10", "10", "10"}, {"10", "10", "10", "10"}, {"10", "10", "--bogus"},
+        {"10", "10", "--seed"}, {"10", "10", "--seed", "-3"}, {"10", "10", "--seed", "abc"},
+        {"10", "10", "--batch", "0"}, {"10", "10", "--batch", "x"}, {"10", "10", "--batch", "2", "--tile-size", "8"},
+        {"10", "10", "--tile-size", "3"}, {"10", "10", "--tile-size"},
+        {"50", "50", "--tile-size", "4294967295"}, {"50", "50", "--tile-size", "4294967298"},
+        {"10", "10", "--threads", "4294967296"},
+        {"10", "10", "--format", "png"}, {"10", "10", "--format", "binary"}, {"10", "10", "--out"},
+        {"10", "10", "--stats"},
+        {"10", "10", "--validate"}, {"10", "10", "--validate", "some"},
+        {"10", "10", "--solve", "dfs"}, {"10", "10", "--solve", "bfs", "--out", "m.bin", "--format", "binary"},
+        {"10", "10", "--algorithm", "prim"},
+        {"10", "10", "--best-of", "0"}, {"10", "10", "--metric", "hardness"},
+        {"10", "10", "--best-of", "4", "--batch", "2"}, {"10", "10", "--best-of", "4", "--tile-size", "8"},
+        {"10", "10", "--best-of", "4", "--stream"},
+        {"10", "10", "--stream", "--batch", "2"}, {"10", "10", "--stream", "--format", "binary"},
+        {"10", "10", "--stream", "--solve", "bfs"}, {"10", "10", "--stream", "--far-endpoints"},
+        {"10", "10", "--stream", "--min-distance", "5"}, {"10", "10", "--stream", "--stats", "report"},
+        {"--serve", "--queue", "0"}, {"--serve", "--max-tiles", "0"}, {"--socket"}
+    };
+    for(const auto& args : rejected) {
+        if(parse(args) == Result::OK) {
+            utils::errorMsg("cmd validator accepted:");
+            for(auto arg : args) {
+                std::cout << " " << arg;
+            }
+            std::cout << std::endl;
+            return Result::NOK;
+        }
+    }
+
+    const std::vector<std::vector<const char*>> accepted = {
+        {"10", "10"}, {"10", "10", "--seed", "42"}, {"--seed", "42", "10", "10"},
+        {"10", "10", "--batch", "3", "--threads", "2"}, {"10", "10", "--tile-size", "8"},
+        {"10", "10", "--out", "maze.bin", "--format", "binary"}, {"10", "10", "--validate", "cheap"},
+        {"10", "10", "--solve", "astar"}, {"10", "10", "--stream"}, {"10", "10", "--algorithm", "growing-tree"},
+        {"10", "10", "--best-of", "8", "--metric", "dead-ends"}, {"--serve"}, {"--socket", "maze.sock"}
+    };
+    for(const auto& args : accepted) {
+        if(parse(args) == Result::NOK) {
+            utils::errorMsg("cmd validator rejected:");
+            for(auto arg : args) {
+                std::cout << " " << arg;
+            }
+            std::cout << std::endl;
+            return Result::NOK;
+        }
+    }
+
+    Options options;
+    const char* args[] = {"exec", "7", "9", "--seed", "18446744073709551615"};
+    input::commandLineArguments(5, args, options);
+    if(options.x != 7 || options.y != 9 || options.seed != 18446744073709551615ull) {
+        utils::errorMsg("cmd parser filled in wrong options!");
+        return Result::NOK;
+    }
+
+    std::cout << "Done!" << std::endl;
+    return Result::OK;
+}
+
+Result seededReproducibility() {
+    std::cout << "Testing seeded generation...";
+    for(std::uint64_t seed : {0ull, 1ull, 42ull, 0xdeadbeefcafeull}) {
+        MazeCreator first({31,17}, seed);
+        MazeCreator second({31,17}, seed);
+        first.create();
+        second.create();
+        if(first.result().array != second.result().array) {
+            utils::errorMsg("Same seed gave different mazes for seed ") << seed << std::endl;
+            return Result::NOK;
+        }
+    }
+
+    MazeCreator first({31,17}, 1);
+    MazeCreator second({31,17}, 2);
+    first.create();
+    second.create();
+    if(first.result().array == second.result().array) {
+        utils::errorMsg("Different seeds gave the same maze!");
+        return Result::NOK;
+    }
+    std::cout << "Done!" << std::endl;
+    return Result::OK;
+}
+
+Result reusedCreator() {
+    std::cout << "Testing reused creator...";
+    MazeCreator reused({64,48}, 0);
+    reused.create();
+    auto buffer = reused.result().array.data();
+    ThreadPool pool(2);
+    const Dimensions sizes[] = {{64,48}, {31,17}, {5,4}, {64,48}, {40,60}};
+    for(std::uint64_t seed = 1; seed <= 5; ++seed) {
+        const auto& dims = sizes[seed - 1];
+        MazeCreator fresh(Dimensions(dims), seed);
+        reused.reset(dims, seed);
+        if(seed % 2) {
+            fresh.create();
+            reused.create();
+        } else {
+            fresh.createTiled(pool, 8);
+            reused.createTiled(pool, 8);
+        }
+        if(reused.result().array != fresh.result().array || reused.result().width != dims.x) {
+            utils::errorMsg("Reused creator differs from a fresh one for seed ") << seed << std::endl;
+            return Result::NOK;
+        }
+        if(seed < 5 && reused.result().array.data() != buffer) {
+            utils::errorMsg("A smaller maze didn't reuse the grid!");
+            return Result::NOK;
+        }
+    }
+    reused.regenerate(3);
+    MazeCreator fresh({40,60}, 3);
+    fresh.create();
+    if(reused.result().array != fresh.result().array) {
+        utils::errorMsg("Regenerated maze differs from a fresh one!");
+        return Result::NOK;
+    }
+    std::cout << "Done!" << std::endl;
+    return Result::OK;
+}
+
+Result serverRequests() {
+    std::cout << "Testing server (ignore subsequent error msgs)\n";
+    ThreadPool pool(3);
+    server::Server server(pool, 2, 1 << 20);
+    std::istringstream in("21 11 5\n\n9 9 6 binary\n1 1\n21 11 text\n17 9 7 text\n");
+    std::ostringstream out;
+    std::ostringstream log;
+    auto* cerrBuffer = std::cerr.rdbuf(log.rdbuf());
+    server.serve(in, out);
+    std::cerr.rdbuf(cerrBuffer);
+    if(not log.str().empty()) {
+        utils::errorMsg("The server logged a bad request: ") << log.str();
         return Result::NOK;
     }
 
-    if(input::commandLineArguments(3)) {
-        utils::errorMsg("cmd validator error for success case!");
+    std::vector<std::string> expected;
+    for(auto [x, y, seed] : {std::tuple{21u, 11u, 5u}, std::tuple{17u, 9u, 7u}}) {
+        MazeCreator mc({x, y}, seed);
+        mc.create();
+        expected.push_back("ok " + std::to_string(x) + " " + std::to_string(y) + " " + std::to_string(seed) + " "
+                           + std::to_string(mc.result().text().size()) + "\n" + std::string(mc.result().text()));
+    }
+    auto response = out.str();
+    auto binary = response.find("ok 9 9 6 ");
+    auto error = response.find("error ");
+    auto randomSeed = response.find("ok 21 11 ", error);
+    if(   response.rfind(expected[0], 0) != 0 || binary == std::string::npos || error < binary
+       || randomSeed == std::string::npos || response.size() < expected[1].size()
+       || response.compare(response.size() - expected[1].size(), std::string::npos, expected[1]) != 0) {
+        utils::errorMsg("Unexpected server responses:") << std::endl << response;
         return Result::NOK;
     }
 
+    std::istringstream hotIn("15 15 3\n");
+    std::ostringstream hotOut;
+    server.serve(hotIn, hotOut);
+    MazeCreator hot({15, 15}, 3);
+    hot.create();
+    if(hotOut.str() != "ok 15 15 3 240\n" + std::string(hot.result().text())) {
+        utils::errorMsg("Unexpected server response for a hot size:") << std::endl << hotOut.str();
+        return Result::NOK;
+    }
+
+    // An oversized request only fails itself, not the ones queued with it.
+    server::Server small(pool, 4, 10'000);
+    std::istringstream bigIn("5 5 1\n100000 100000 1\n5 5 2\n");
+    std::ostringstream bigOut;
+    small.serve(bigIn, bigOut);
+    auto big = bigOut.str();
+    auto refused = big.find("error the maze is larger than 10000 tiles\n");
+    if(   big.rfind("ok 5 5 1 30\n", 0) != 0 || refused == std::string::npos
+       || big.find("ok 5 5 2 30\n", refused) == std::string::npos) {
+        utils::errorMsg("Unexpected server responses to an oversized request:") << std::endl << big;
+        return Result::NOK;
+    }
+    std::cout << "Done!" << std::endl;
+    return Result::OK;
+}
+
+Result chunkedWorld() {
+    std::cout << "Testing chunked world...";
+    const unsigned side = 3 * 17 + 1;   // 3x3 chunks of 16 with their seams, from the world's corner
+    for(std::uint64_t seed = 1; seed <= 5; ++seed) {
+        world::ChunkedWorld small(seed, 16, 4);
+        world::ChunkedWorld large(seed, 16, 64);
+        for(unsigned i = side; i-- > 0;) {   // fault the chunks in in another order
+            large.at({i, side - 1 - i});
+        }
+        auto view = small.window({0, 0}, {side, side});
+        if(view.array != large.window({0, 0}, {side, side}).array || small.cachedChunks() > 4) {
+            utils::errorMsg("Chunked world depends on the cache for seed ") << seed << std::endl;
+            return Result::NOK;
+        }
+        small.at({4'000'000'000u, 4'000'000'000u});
+        auto part = small.window({5, 9}, {30, 20});
+        for(unsigned y = 0; y < 20; ++y) {
+            if(std::string_view(part.row(y), 30) != std::string_view(view.row(y + 9) + 5, 30)) {
+                utils::errorMsg("Chunked world differs after eviction for seed ") << seed << std::endl;
+                return Result::NOK;
+            }
+        }
+
+        // The doors out of the view lead to chunks it doesn't show.
+        for(unsigned i = 0; i < side; ++i) {
+            view[{side - 1, i}] = WALL;
+            view[{i, side - 1}] = WALL;
+        }
+        if(   validate::output::noFreeClusters(view) == Result::NOK
+           || validate::output::fullyTraversable(view) == Result::NOK) {
+            utils::errorMsg("Invalid chunked world for seed ") << seed << std::endl << view;
+            return Result::NOK;
+        }
+    }
+
+    // Seams without a door, forced for all or some of them, fall back to perfect maze chunks.
+    for(unsigned size : {16u, 17u}) {
+        for(std::uint64_t every : {1u, 3u}) {
+            const unsigned span = 3 * (size + 1) + 1;
+            world::ChunkedWorld small(every, size, 2);
+            world::ChunkedWorld large(every, size, 64);
+            small.failDoorSearch(every);
+            large.failDoorSearch(every);
+            large.at({span, span});
+            auto view = small.window({0, 0}, {span, span});
+            if(view.array != large.window({0, 0}, {span, span}).array || not small.fallbackChunks()) {
+                utils::errorMsg("Chunked world fallback depends on the cache: ") << size << " " << every << std::endl;
+                return Result::NOK;
+            }
+            for(unsigned i = 0; i < span; ++i) {
+                view[{span - 1, i}] = WALL;
+                view[{i, span - 1}] = WALL;
+            }
+            if(   validate::output::noFreeClusters(view) == Result::NOK
+               || validate::output::fullyTraversable(view) == Result::NOK) {
+                utils::errorMsg("Invalid chunked world with fallbacks: ") << size << " " << every << std::endl << view;
+                return Result::NOK;
+            }
+        }
+    }
     std::cout << "Done!" << std::endl;
     return Result::OK;
 }
@@ -139,6 +740,249 @@ Result dimensionTests()  {
     return Result::OK;
 }
 
+Result traversalValidator() {
+    std::cout << "Testing traversal validator (ignore subsequent error msgs)\n";
+    Maze maze({7,5});
+    maze.fill(WALL);
+    for(unsigned int y = 1; y <= 3; ++y) {
+        maze[{1, y}] = EMPTY;
+        maze[{5, y}] = EMPTY;
+    }
+    maze[{2, 1}] = BEGIN;
+    maze[{4, 3}] = END;
+    auto regions = output::connectedRegions(maze);
+    if(   output::fullyTraversable(maze) != Result::NOK || regions.size() != 2
+       || regions[0].size != 4 || regions[1].size != 4 || regions[1].first.x != 5) {
+        utils::errorMsg("Separate regions were not found!");
+        return Result::NOK;
+    }
+
+    maze[{3, 2}] = EMPTY;   // diagonal steps join the two sides
+    if(output::fullyTraversable(maze) != Result::OK || output::connectedRegions(maze).size() != 1) {
+        utils::errorMsg("Connected maze was found to be separated!");
+        return Result::NOK;
+    }
+    std::cout << "Done!" << std::endl;
+    return Result::OK;
+}
+
+Result mazeAnalytics() {
+    std::cout << "Testing maze analytics...";
+    Maze maze({7,5});
+    maze.fill(WALL);
+    for(unsigned int x = 1; x <= 5; ++x) {
+        maze[{x, 1}] = EMPTY;
+        maze[{x, 3}] = EMPTY;
+    }
+    for(unsigned int x : {1, 3, 5}) {
+        maze[{x, 2}] = EMPTY;
+    }
+    maze[{1, 1}] = BEGIN;
+    maze[{5, 3}] = END;
+    auto analysis = analytics::analyze(maze);
+    if(   analysis.openTiles != 13 || analysis.deadEnds != 0 || analysis.junctions != 2 || analysis.loops != 2
+       || analysis.pathLength != 4 || std::abs(analysis.branchingFactor - 15.0 / 13) > 1e-9) {
+        utils::errorMsg("Wrong analysis of the handmade maze: ");
+        analytics::writeJson(std::cout, analysis);
+        std::cout << std::endl;
+        return Result::NOK;
+    }
+    maze[{5, 2}] = WALL;
+    analysis = analytics::analyze(maze);
+    if(analysis.deadEnds != 2 || analysis.junctions != 2 || analysis.loops != 1 || analysis.pathLength != 4) {
+        utils::errorMsg("Wrong analysis of the handmade maze with dead ends!");
+        return Result::NOK;
+    }
+
+    for(std::uint64_t seed = 0; seed < 30; ++seed) {
+        MazeCreator mc({37,23}, seed);
+        mc.create();
+        analysis = analytics::analyze(mc.result());
+        auto solution = solve::shortestPath(mc.result(), solve::Algorithm::BFS);
+        if(analysis.pathLength != solution.moves.size() || not analysis.deadEnds || analysis.branchingFactor < 1) {
+            utils::errorMsg("Analysis disagrees with the maze for seed ") << seed << std::endl << mc.result();
+            return Result::NOK;
+        }
+        MazeCreator perfect({37,23}, seed);
+        perfect.useAlgorithm(carve::Algorithm::KRUSKAL);
+        perfect.create();
+        analysis = analytics::analyze(perfect.result());
+        if(analysis.loops != 0 || not analysis.deadEnds) {
+            utils::errorMsg("Perfect maze with loops for seed ") << seed << std::endl << perfect.result();
+            return Result::NOK;
+        }
+    }
+    std::cout << "Done!" << std::endl;
+    return Result::OK;
+}
+
+Result solvers() {
+    std::cout << "Testing solvers...";
+    const solve::Algorithm algorithms[] = {solve::Algorithm::BFS, solve::Algorithm::ASTAR,
+                                           solve::Algorithm::BIDIRECTIONAL};
+    Maze maze({7,5});
+    maze.fill(WALL);
+    for(unsigned int x = 1; x <= 5; ++x) {
+        maze[{x, 1}] = EMPTY;
+    }
+    maze[{5, 2}] = EMPTY;
+    maze[{1, 2}] = BEGIN;
+    maze[{4, 3}] = END;
+    for(auto algorithm : algorithms) {
+        auto solution = solve::shortestPath(maze, algorithm);
+        if(not solution.solved || solution.moves != "96631") {
+            utils::errorMsg("Wrong path in the handmade maze by ") << solve::name(algorithm) << ": "
+                << solution.moves << std::endl;
+            return Result::NOK;
+        }
+    }
+    maze[{5, 2}] = WALL;
+    if(solve::shortestPath(maze, solve::Algorithm::BIDIRECTIONAL).solved) {
+        utils::errorMsg("Separated B and E were solved!");
+        return Result::NOK;
+    }
+
+    for(std::uint64_t seed = 0; seed < 50; ++seed) {
+        MazeCreator mc({37,23}, seed);
+        mc.create();
+        std::size_t steps = 0;
+        for(auto algorithm : algorithms) {
+            auto solution = solve::shortestPath(mc.result(), algorithm);
+            auto drawn = mc.result();
+            solve::overlay(drawn, solution);
+            auto pathTiles = std::count(drawn.array.begin(), drawn.array.end(), PATH);
+            if(   not solution.solved || (steps && solution.moves.size() != steps)
+               || std::size_t(pathTiles) + 1 != solution.moves.size()) {
+                utils::errorMsg("Solvers disagree for seed ") << seed << std::endl << drawn;
+                return Result::NOK;
+            }
+            steps = solution.moves.size();
+        }
+    }
+
+    // Long enough for the queue to drop its taken part on the way.
+    std::vector<std::size_t> buffer;
+    utils::Fifo<std::size_t> fifo(buffer);
+    const std::size_t waiting = 10000;   // items queued ahead of the one taken
+    for(std::size_t i = 0; i < waiting; ++i) {
+        fifo.push(i);
+    }
+    for(std::size_t i = 0; i < 5 * waiting; ++i) {
+        fifo.push(waiting + i);
+        if(fifo.pop() != i) {
+            utils::errorMsg("The FIFO lost its order at ") << i << std::endl;
+            return Result::NOK;
+        }
+    }
+    if(buffer.size() > 2 * waiting + 1) {
+        utils::errorMsg("The FIFO kept its taken part: ") << buffer.size() << std::endl;
+        return Result::NOK;
+    }
+    // Large enough for the solvers' queues to drop their taken part on the way.
+    MazeCreator large({301, 301}, 9);
+    large.create();
+    auto bfs = solve::shortestPath(large.result(), solve::Algorithm::BFS);
+    auto bidirectional = solve::shortestPath(large.result(), solve::Algorithm::BIDIRECTIONAL);
+    if(   not bfs.solved || bfs.moves.size() != bidirectional.moves.size()
+       || output::fullyTraversable(large.result()) == Result::NOK) {
+        utils::errorMsg("Solvers disagree in a large maze") << std::endl;
+        return Result::NOK;
+    }
+    std::cout << "Done!" << std::endl;
+    return Result::OK;
+}
+
+Result endpointPlacement() {
+    std::cout << "Testing endpoint placement...";
+    auto steps = [](const Maze& maze) {
+        return solve::shortestPath(maze, solve::Algorithm::BFS).moves.size();
+    };
+    std::size_t randomSteps = 0;
+    std::size_t farSteps = 0;
+    for(std::uint64_t seed = 0; seed < 30; ++seed) {
+        MazeCreator random({41,29}, seed);
+        MazeCreator far({41,29}, seed);
+        MazeCreator apart({41,29}, seed);
+        far.placeEndpoints({true, 0});
+        apart.placeEndpoints({false, 15});
+        random.create();
+        far.create();
+        apart.create();
+        randomSteps += steps(random.result());
+        farSteps += steps(far.result());
+        if(   output::endpointsApart(apart.result(), 15) == Result::NOK
+           || output::fullyTraversable(far.result()) == Result::NOK) {
+            utils::errorMsg("Endpoints placed too close for seed ") << seed << std::endl << apart.result();
+            return Result::NOK;
+        }
+    }
+    if(farSteps < 2 * randomSteps) {
+        utils::errorMsg("Far endpoints are not much farther than random ones: ") << farSteps << " vs "
+            << randomSteps << std::endl;
+        return Result::NOK;
+    }
+
+    MazeCreator tooSmall({6,6}, 1);
+    tooSmall.placeEndpoints({false, 1000});
+    tooSmall.create();
+    if(   std::count(tooSmall.result().array.begin(), tooSmall.result().array.end(), END) != 1
+       || output::endpointsApart(tooSmall.result(), 1000) != Result::NOK) {
+        utils::errorMsg("Unreachable minimum distance was not settled for the farthest tile!");
+        return Result::NOK;
+    }
+    std::cout << "Done!" << std::endl;
+    return Result::OK;
+}
+
+Result generationStats() {
+    std::cout << "Testing generation stats...";
+    MazeCreator mc({61,47}, 7);
+    mc.create();
+    const auto& stats = mc.stats();
+    bool recorded = stats.drawRounds && stats.peakFrontier && stats.rngDraws && stats.wallsAdded
+                    && stats.wallsAdded <= stats.gapsChecked;
+    bool empty = not stats.drawRounds && not stats.peakFrontier && not stats.rngDraws
+                 && not stats.gapsChecked && not stats.wallsAdded;
+    if(stats::ENABLED ? not recorded : not empty) {
+        utils::errorMsg("Unexpected generation counters!");
+        return Result::NOK;
+    }
+    std::cout << "Done!" << std::endl;
+    return Result::OK;
+}
+
+Result tileKernels() {
+    std::cout << "Testing " << kernels::instructionSet() << " tile kernels...";
+    rng::SplitMix64 random(5);
+    for(std::size_t length = 1; length < 100; ++length) {
+        for(int round = 0; round < 20; ++round) {
+            std::string top(length, WALL), bottom(length, WALL), row(length, PATH);
+            for(std::size_t x = 0; x < length; ++x) {
+                top[x] = random() % 4 ? EMPTY : WALL;
+                bottom[x] = random() % 4 ? EMPTY : WALL;
+                row[x] = "o o x"[random() % 5];
+            }
+            bool expectedCluster = false;
+            for(std::size_t x = 0; x + 1 < length; ++x) {
+                expectedCluster |= top[x] == EMPTY && top[x+1] == EMPTY && bottom[x] == EMPTY && bottom[x+1] == EMPTY;
+            }
+            std::string expectedRow = row;
+            std::replace(expectedRow.begin(), expectedRow.end(), EMPTY, WALL);
+            std::replace(expectedRow.begin(), expectedRow.end(), PATH, EMPTY);
+            auto original = row;
+            bool allExpected = kernels::flipRow(row.data(), length);
+            if(   kernels::hasFreeCluster(top.data(), bottom.data(), length) != expectedCluster
+               || allExpected != (original.find(WALL) == std::string::npos)
+               || row != expectedRow) {
+                utils::errorMsg("Kernel mismatch for length ") << length << std::endl;
+                return Result::NOK;
+            }
+        }
+    }
+    std::cout << "Done!" << std::endl;
+    return Result::OK;
+}
+
 Result runOneHundredMazes() {
     std::cout << "Running 100 mazes...";
     for(int i = 0; i < 100; ++i) {
@@ -149,7 +993,7 @@ Result runOneHundredMazes() {
             utils::errorMsg("Large free cluster in map!") << std::endl << mc.result();
             return Result::NOK;
         }
-        if(output::fullyTraversable(mc) == Result::NOK) {
+        if(output::fullyTraversable(mc.result()) == Result::NOK) {
             utils::errorMsg("Maze not fully traversible!") << std::endl << mc.result();
             return Result::NOK;
         }
@@ -162,9 +1006,30 @@ Result runOneHundredMazes() {
 Result tests() {
     return (   dimensionTests() == Result::OK
             && commandLineArgs() == Result::OK
+            && traversalValidator() == Result::OK
+            && solvers() == Result::OK
+            && mazeAnalytics() == Result::OK
+            && endpointPlacement() == Result::OK
+            && generationStats() == Result::OK
+            && tileKernels() == Result::OK
             && runOneHundredMazes() == Result::OK
+            && seededReproducibility() == Result::OK
+            && reusedCreator() == Result::OK
+            && serverRequests() == Result::OK
+            && chunkedWorld() == Result::OK
+            && batchGeneration() == Result::OK
+            && bestOfGeneration() == Result::OK
+            && tiledGeneration() == Result::OK
+            && carveAlgorithms() == Result::OK
+            && streamedGeneration() == Result::OK
+            && bitboardGeneration() == Result::OK
+            && fixedSizeGeneration() == Result::OK
+            && binaryFormat() == Result::OK
             && subsequentRandomization() == Result::OK
-            && randDistribution() == Result::OK)
+            && randDistribution() == Result::OK
+            && rngEngine<rng::Xoshiro256StarStar>("xoshiro256**") == Result::OK
+            && rngEngine<rng::SplitMix64>("splitmix64") == Result::OK
+            && rngEngine<std::mt19937_64>("mt19937_64") == Result::OK)
             ? Result::OK : Result::NOK;
 }
 }